@@ -0,0 +1,172 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    =============================================
+    Example: Broadcasting control messages
+    =============================================
+
+    This example illustrates how a `mpsc_broadcast_t` instance can be
+    used to push configuration data from a control thread (here, the
+    main thread) to all of the producers of a `mpsc_t` channel. Each
+    producer owns a subscriber, which it polls using
+    `mpsc_broadcast_try_receive` between two messages, in the same way
+    that `mpsc_producer_ping` would be used. When the control thread
+    closes the broadcast channel, the producers return, which allows
+    the call to `mpsc_join` to return.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (4)
+#define N_CONFIGURATIONS (5)
+#define CONFIGURATION_INTERVAL_US (20000)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+struct my_configuration
+{
+    size_t multiplier;
+};
+
+struct my_message
+{
+    size_t producer_id;
+    size_t value;
+};
+
+struct my_producer_thread_callback_context
+{
+    size_t id;
+    mpsc_broadcast_subscriber_t *subscriber;
+};
+
+static size_t last_values[N_PRODUCERS];
+
+int main(void)
+{
+    mpsc_broadcast_t *control = mpsc_broadcast_create((mpsc_broadcast_create_params_t){
+        .buffer_size = sizeof(struct my_configuration),
+        .capacity = 2,
+        .n_max_subscribers = N_PRODUCERS,
+        .error_handling_enabled = false,
+    });
+
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(struct my_message),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+
+    struct my_producer_thread_callback_context contexts[N_PRODUCERS];
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        contexts[i].id = i;
+        // NOTE: Subscribing here, rather than inside the producer thread, guarantees
+        // that no configuration message is missed.
+        contexts[i].subscriber = mpsc_broadcast_subscribe(control);
+        assert(contexts[i].subscriber != NULL);
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, &contexts[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    for (size_t i = 1; i <= N_CONFIGURATIONS; i++)
+    {
+        struct my_configuration configuration = {.multiplier = i};
+        assert(mpsc_broadcast_send(control, &configuration, sizeof(struct my_configuration)));
+        fprintf(stdout, "[control] broadcasted 'multiplier = %zu'\n", i);
+        usleep(CONFIGURATION_INTERVAL_US);
+    }
+    mpsc_broadcast_close(control);
+
+    mpsc_join(mpsc);
+    mpsc_broadcast_destroy(control);
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(last_values[i] == i * N_CONFIGURATIONS);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        fprintf(stdout, "[consumer] closed\n");
+        return;
+    }
+    if (n != sizeof(struct my_message))
+    {
+        fprintf(stderr, "[consumer] Error: Unexpected message size\n");
+        exit(EXIT_FAILURE);
+    }
+    struct my_message *message = data;
+    last_values[message->producer_id] = message->value;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    struct my_producer_thread_callback_context *ctx = mpsc_producer_context(producer);
+    size_t multiplier = 0;
+    while (true)
+    {
+        const void *data;
+        size_t n;
+        mpsc_broadcast_receive_status_t status = mpsc_broadcast_try_receive(ctx->subscriber, &data, &n);
+        if (status == MPSC_BROADCAST_RECEIVE_STATUS_CLOSED)
+        {
+            break;
+        }
+        if (status == MPSC_BROADCAST_RECEIVE_STATUS_MESSAGE)
+        {
+            assert(n == sizeof(struct my_configuration));
+            multiplier = ((const struct my_configuration *)data)->multiplier;
+            mpsc_broadcast_release(ctx->subscriber);
+            fprintf(stdout, "[producer:%zu] now using 'multiplier = %zu'\n", ctx->id, multiplier);
+        }
+        struct my_message message = {.producer_id = ctx->id, .value = ctx->id * multiplier};
+        if (!mpsc_producer_send(producer, &message, sizeof(struct my_message)))
+        {
+            break;
+        }
+        usleep(1000);
+    }
+    mpsc_broadcast_unsubscribe(ctx->subscriber);
+}
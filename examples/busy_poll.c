@@ -0,0 +1,122 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Busy-polling consumer
+    ==========================================
+
+    This example illustrates how `busy_poll_enabled` can be used to have the
+    consumer thread spin on the channel, instead of sleeping, while waiting for
+    messages. Producers send bursts of timestamped messages, separated by pauses
+    that are longer than `busy_poll_idle_timeout_us`, so that the consumer thread
+    parks between bursts, and polls again as soon as a new burst begins. The
+    consumer reports the average delivery latency.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (2)
+#define N_BURSTS (5)
+#define N_MESSAGES_PER_BURST (1000)
+#define IDLE_TIMEOUT_US (500)
+#define PAUSE_BETWEEN_BURSTS_MS (5)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static uint64_t my_now_ns(void);
+
+static size_t n_received = 0;
+static uint64_t total_latency_ns = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(uint64_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .busy_poll_enabled = true,
+        .busy_poll_idle_timeout_us = IDLE_TIMEOUT_US,
+    });
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_BURSTS * N_MESSAGES_PER_BURST);
+    fprintf(stdout, "[main] %zu messages were received, with an average latency of %" PRIu64 " ns\n", n_received, total_latency_ns / n_received);
+
+    exit(EXIT_SUCCESS);
+}
+
+static uint64_t my_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(uint64_t));
+    uint64_t sent_at = *(uint64_t *)data;
+    free(data);
+    total_latency_ns += my_now_ns() - sent_at;
+    n_received += 1;
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t burst = 0; burst < N_BURSTS; burst++)
+    {
+        for (size_t i = 0; i < N_MESSAGES_PER_BURST; i++)
+        {
+            uint64_t now = my_now_ns();
+            assert(mpsc_producer_send(producer, &now, sizeof(uint64_t)));
+        }
+        // NOTE: Long enough for the consumer thread to park.
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = PAUSE_BETWEEN_BURSTS_MS * 1000000L}, NULL);
+    }
+}
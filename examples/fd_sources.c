@@ -0,0 +1,145 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: File descriptor sources
+    ==========================================
+
+    This example illustrates how `mpsc_register_fd_source` can be used to have
+    a single internal thread read from many file descriptors, instead of
+    dedicating one (blocking) producer thread to each of them. The read ends
+    of many pipes are registered with a newline-delimited framing function,
+    after which the main thread writes lines to all of the pipes, and closes
+    them. The consumer checks that each pipe's lines are received in order.
+    A regular file, which can't be polled, is also rejected without being
+    modified (i.e., it remains owned by the application).
+*/
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PIPES (256)
+#define N_LINES_PER_PIPE (100)
+#define MAX_LINE_SIZE (64)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static size_t my_line_framing(const void *data, size_t n, size_t *message_offset, size_t *message_size, void *context);
+
+static size_t next_lines[N_PIPES];
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = MAX_LINE_SIZE,
+        .n_max_producers = 1,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+
+    int write_fds[N_PIPES];
+    for (size_t i = 0; i < N_PIPES; i++)
+    {
+        int fds[2];
+        assert(pipe(fds) == 0);
+        write_fds[i] = fds[1];
+        // NOTE: The channel takes ownership of the read end.
+        assert(mpsc_register_fd_source(mpsc, fds[0], my_line_framing, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    FILE *file = tmpfile();
+    assert(file != NULL);
+    int flags = fcntl(fileno(file), F_GETFL);
+    assert(mpsc_register_fd_source(mpsc, fileno(file), my_line_framing, NULL) == MPSC_REGISTER_PRODUCER_ERROR_INVALID_FD);
+    assert(fcntl(fileno(file), F_GETFL) == flags);
+    fclose(file);
+
+    for (size_t line = 0; line < N_LINES_PER_PIPE; line++)
+    {
+        for (size_t i = 0; i < N_PIPES; i++)
+        {
+            char text[MAX_LINE_SIZE];
+            int length = snprintf(text, sizeof(text), "%zu %zu\n", i, line);
+            assert(write(write_fds[i], text, (size_t)length) == length);
+        }
+    }
+    for (size_t i = 0; i < N_PIPES; i++)
+    {
+        close(write_fds[i]);
+    }
+
+    // NOTE: Returns once every pipe has reached end-of-file.
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PIPES * N_LINES_PER_PIPE);
+    fprintf(stdout, "[main] %zu lines were received, in order, from %d pipes, by a single internal thread\n", n_received, N_PIPES);
+
+    exit(EXIT_SUCCESS);
+}
+
+static size_t my_line_framing(const void *data, size_t n, size_t *message_offset, size_t *message_size, void *context)
+{
+    IGNORE_UNUSED(context);
+    const char *newline = memchr(data, '\n', n);
+    if (newline == NULL)
+    {
+        return 0;
+    }
+    *message_offset = 0;
+    *message_size = (size_t)(newline - (const char *)data);
+    return *message_size + 1;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n > 0 && n < MAX_LINE_SIZE);
+    char text[MAX_LINE_SIZE];
+    memcpy(text, data, n);
+    text[n] = '\0';
+    free(data);
+    size_t pipe_index;
+    size_t line;
+    assert(sscanf(text, "%zu %zu", &pipe_index, &line) == 2);
+    assert(pipe_index < N_PIPES);
+    assert(line == next_lines[pipe_index]);
+    next_lines[pipe_index] += 1;
+    n_received += 1;
+}
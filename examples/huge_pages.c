@@ -0,0 +1,128 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Huge pages (benchmark)
+    ==========================================
+
+    This example compares a broadcast ring (see `mpsc_broadcast_create`) whose
+    slots are a few megabytes each, backed by regular pages, with the same ring
+    backed by huge pages (i.e., `huge_pages_enabled = true`). For each ring, the
+    producer repeatedly fills every slot, and a subscriber then sweeps every
+    slot's memory in place, which is where TLB misses show up. The timings
+    depend on the machine (and on whether huge pages are available), so they
+    are only reported.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define SLOT_SIZE ((size_t)2 * 1024 * 1024)
+#define N_SLOTS (16)
+#define N_ROUNDS (64)
+#define STRIDE (4096 + 64)
+
+static double my_benchmark(bool huge_pages_enabled);
+static double my_now_s(void);
+
+int main(void)
+{
+    double regular_s = my_benchmark(false);
+    double huge_s = my_benchmark(true);
+    fprintf(stdout, "[main] regular pages: %.3f ms\n", regular_s * 1e3);
+    fprintf(stdout, "[main] huge pages:    %.3f ms (%.2fx)\n", huge_s * 1e3, regular_s / huge_s);
+    exit(EXIT_SUCCESS);
+}
+
+static double my_now_s(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static double my_benchmark(bool huge_pages_enabled)
+{
+    mpsc_broadcast_t *broadcast = mpsc_broadcast_create((mpsc_broadcast_create_params_t){
+        .buffer_size = SLOT_SIZE,
+        .capacity = N_SLOTS,
+        .n_max_subscribers = 1,
+        .error_handling_enabled = false,
+        .huge_pages_enabled = huge_pages_enabled,
+    });
+    mpsc_broadcast_subscriber_t *subscriber = mpsc_broadcast_subscribe(broadcast);
+    assert(subscriber != NULL);
+
+    uint8_t *message = malloc(SLOT_SIZE);
+    assert(message != NULL);
+    memset(message, 1, SLOT_SIZE);
+
+    // NOTE: Only the sweeps are timed, and the first round (which faults the
+    // ring's pages in) isn't.
+    double elapsed = 0;
+    uint64_t sum = 0;
+    for (size_t round = 0; round <= N_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < N_SLOTS; i++)
+        {
+            assert(mpsc_broadcast_send(broadcast, message, SLOT_SIZE));
+        }
+        if (round == 1)
+        {
+            sum = 0;
+        }
+        double start = my_now_s();
+        for (size_t i = 0; i < N_SLOTS; i++)
+        {
+            const void *data;
+            size_t n;
+            assert(mpsc_broadcast_receive(subscriber, &data, &n) == MPSC_BROADCAST_RECEIVE_STATUS_MESSAGE);
+            assert(n == SLOT_SIZE);
+            // NOTE: One byte per (regular) page, so that the sweep is dominated by address translation.
+            for (size_t offset = 0; offset < n; offset += STRIDE)
+            {
+                sum += ((const uint8_t *)data)[offset];
+            }
+            mpsc_broadcast_release(subscriber);
+        }
+        if (round > 0)
+        {
+            elapsed += my_now_s() - start;
+        }
+    }
+    assert(sum == (uint64_t)N_ROUNDS * N_SLOTS * ((SLOT_SIZE + STRIDE - 1) / STRIDE));
+
+    free(message);
+    mpsc_broadcast_unsubscribe(subscriber);
+    mpsc_broadcast_destroy(broadcast);
+    return elapsed;
+}
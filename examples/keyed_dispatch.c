@@ -0,0 +1,147 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Key-ordered parallel dispatch
+    ==========================================
+
+    This example illustrates how `n_dispatch_workers` can be used to
+    process messages on several threads while preserving the order of
+    the messages sharing the same key. Each producer sends a sequence
+    of numbered messages for each of the `N_KEYS` keys (using
+    `mpsc_producer_send_keyed`), and the consumer callback, which is
+    executed on the dispatch worker owning the message's key, checks that
+    the messages of a given (producer, key) pair arrive in order. Since a
+    key is always handled by the same worker, the per-key state below
+    doesn't need to be protected by a mutex.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (4)
+#define N_KEYS (16)
+#define N_MESSAGES_PER_KEY (250)
+#define N_DISPATCH_WORKERS (4)
+#define DISPATCH_QUEUE_CAPACITY (8)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+struct my_message
+{
+    size_t producer_id;
+    size_t key;
+    size_t sequence;
+};
+
+struct my_producer_thread_callback_context
+{
+    size_t id;
+};
+
+static size_t next_sequences[N_PRODUCERS][N_KEYS];
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(struct my_message),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .n_dispatch_workers = N_DISPATCH_WORKERS,
+        .dispatch_queue_capacity = DISPATCH_QUEUE_CAPACITY,
+    });
+
+    struct my_producer_thread_callback_context contexts[N_PRODUCERS];
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        contexts[i].id = i;
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, &contexts[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        for (size_t j = 0; j < N_KEYS; j++)
+        {
+            assert(next_sequences[i][j] == N_MESSAGES_PER_KEY);
+        }
+    }
+    fprintf(stdout, "[main] all %d messages were delivered in key order\n", N_PRODUCERS * N_KEYS * N_MESSAGES_PER_KEY);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        fprintf(stdout, "[consumer] closed\n");
+        return;
+    }
+    if (n != sizeof(struct my_message))
+    {
+        fprintf(stderr, "[consumer] Error: Unexpected message size\n");
+        exit(EXIT_FAILURE);
+    }
+    struct my_message *message = data;
+    size_t *next_sequence = &next_sequences[message->producer_id][message->key];
+    if (message->sequence != *next_sequence)
+    {
+        fprintf(
+            stderr,
+            "[consumer] Error: expected message #%zu for key %zu (producer %zu), got #%zu\n",
+            *next_sequence, message->key, message->producer_id, message->sequence);
+        exit(EXIT_FAILURE);
+    }
+    *next_sequence += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    struct my_producer_thread_callback_context *ctx = mpsc_producer_context(producer);
+    for (size_t sequence = 0; sequence < N_MESSAGES_PER_KEY; sequence++)
+    {
+        for (size_t key = 0; key < N_KEYS; key++)
+        {
+            struct my_message message = {.producer_id = ctx->id, .key = key, .sequence = sequence};
+            assert(mpsc_producer_send_keyed(producer, (uint64_t)key, &message, sizeof(struct my_message)));
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Latency histograms
+    ==========================================
+
+    This example illustrates how `latency_histograms_enabled` and
+    `mpsc_latency_histograms` can be used to look at a channel's tail latencies.
+    The consumer callback is usually fast, but one message in a hundred takes
+    much longer, which barely moves the median, but shows up in the p99 and p999
+    of the callback duration, as well as in the time it takes the other
+    messages to reach the consumer, and in the duration of the send calls.
+*/
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (2)
+#define N_MESSAGES_PER_PRODUCER (1000)
+#define SLOW_MESSAGE_INTERVAL (100)
+#define SLOW_CALLBACK_US (2000)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static void my_print_histogram(const char *name, const mpsc_histogram_t *histogram);
+
+static mpsc_t *mpsc = NULL;
+static size_t n_received = 0;
+// NOTE: About 14 KiB, so kept off the consumer thread's stack.
+static mpsc_latency_histograms_t histograms;
+
+int main(void)
+{
+    // NOTE: Each bucket starts right after the previous one.
+    for (size_t i = 1; i < MPSC_HISTOGRAM_N_BUCKETS; i++)
+    {
+        assert(mpsc_histogram_bucket_upper_bound(i) > mpsc_histogram_bucket_upper_bound(i - 1));
+    }
+
+    mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(uint64_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .latency_histograms_enabled = true,
+    });
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_print_histogram(const char *name, const mpsc_histogram_t *histogram)
+{
+    fprintf(
+        stdout,
+        "[consumer] %-10s n = %" PRIu64 ", min = %" PRIu64 " ns, p50 = %" PRIu64 " ns, p99 = %" PRIu64 " ns, p999 = %" PRIu64 " ns, max = %" PRIu64 " ns\n",
+        name,
+        histogram->n_samples,
+        histogram->min_ns,
+        mpsc_histogram_percentile(histogram, 50.0),
+        mpsc_histogram_percentile(histogram, 99.0),
+        mpsc_histogram_percentile(histogram, 99.9),
+        histogram->max_ns);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        // NOTE: The channel is only destroyed by `mpsc_join`, once this call returns.
+        mpsc_latency_histograms(mpsc, &histograms);
+        my_print_histogram("send:", &histograms.send);
+        my_print_histogram("delivery:", &histograms.delivery);
+        my_print_histogram("callback:", &histograms.callback);
+        assert(histograms.send.n_samples == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+        assert(histograms.delivery.n_samples == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+        assert(histograms.callback.n_samples == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+        // NOTE: Bucket bounds are within 1/16 of the values they hold.
+        uint64_t slow_callback_ns = SLOW_CALLBACK_US * 1000u;
+        assert(histograms.callback.max_ns >= slow_callback_ns);
+        assert(mpsc_histogram_percentile(&histograms.callback, 50.0) < slow_callback_ns / 2);
+        assert(mpsc_histogram_percentile(&histograms.callback, 99.9) >= slow_callback_ns - slow_callback_ns / 16);
+        assert(mpsc_histogram_percentile(&histograms.callback, 100.0) == histograms.callback.max_ns);
+        return;
+    }
+    assert(n == sizeof(uint64_t));
+    free(data);
+    n_received += 1;
+    if (n_received % SLOW_MESSAGE_INTERVAL == 0)
+    {
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = SLOW_CALLBACK_US * 1000L}, NULL);
+    }
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (uint64_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(uint64_t)));
+    }
+}
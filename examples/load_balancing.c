@@ -0,0 +1,142 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ============================================
+    Example: Load balancing across channels
+    ============================================
+
+    This example illustrates how `mpsc_attach_producer` and `mpsc_send_any`
+    can be used to spread messages over several channels (i.e., shards),
+    each with its own consumer, without a central dispatcher thread. The
+    main thread holds one attached producer per shard and sends each
+    message to the first shard that can accept it. Since the consumers
+    don't all run at the same speed, the faster shards end up receiving
+    more messages.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_SHARDS (3)
+#define N_MESSAGES (300)
+#define SLOWEST_CONSUMER_SLEEP_US (3000)
+
+static void my_consume(size_t shard, void *data, bool closed);
+static void my_consumer_callback_0(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_consumer_callback_1(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_consumer_callback_2(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+
+static mpsc_consumer_callback_t *consumer_callbacks[N_SHARDS] = {
+    my_consumer_callback_0,
+    my_consumer_callback_1,
+    my_consumer_callback_2,
+};
+
+static size_t n_received[N_SHARDS];
+
+int main(void)
+{
+    mpsc_t *shards[N_SHARDS];
+    mpsc_producer_t *producers[N_SHARDS];
+    size_t n_sent[N_SHARDS] = {0};
+
+    for (size_t i = 0; i < N_SHARDS; i++)
+    {
+        shards[i] = mpsc_create((mpsc_create_params_t){
+            .buffer_size = sizeof(size_t),
+            .n_max_producers = 1,
+            .consumer_callback = consumer_callbacks[i],
+            .consumer_error_callback = NULL,
+            .error_handling_enabled = false,
+            .create_and_join_thread_safety_disabled = false,
+        });
+        assert(mpsc_attach_producer(shards[i], &producers[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    for (size_t i = 0; i < N_MESSAGES; i++)
+    {
+        ssize_t index = mpsc_send_any(producers, N_SHARDS, &i, sizeof(size_t));
+        assert(index >= 0);
+        n_sent[index] += 1;
+    }
+
+    for (size_t i = 0; i < N_SHARDS; i++)
+    {
+        mpsc_producer_detach(producers[i]);
+        mpsc_join(shards[i]);
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < N_SHARDS; i++)
+    {
+        fprintf(stdout, "[main] shard #%zu received %zu message(s)\n", i, n_received[i]);
+        assert(n_received[i] == n_sent[i]);
+        total += n_received[i];
+    }
+    assert(total == N_MESSAGES);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consume(size_t shard, void *data, bool closed)
+{
+    if (closed)
+    {
+        return;
+    }
+    // NOTE: Each shard has its own consumer thread, so no synchronization is needed here.
+    n_received[shard] += 1;
+    free(data);
+    // NOTE: Shard #0 is the slowest consumer and the last shard is the fastest.
+    usleep(SLOWEST_CONSUMER_SLEEP_US / (shard + 1));
+}
+
+static void my_consumer_callback_0(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    IGNORE_UNUSED(n);
+    my_consume(0, data, closed);
+}
+
+static void my_consumer_callback_1(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    IGNORE_UNUSED(n);
+    my_consume(1, data, closed);
+}
+
+static void my_consumer_callback_2(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    IGNORE_UNUSED(n);
+    my_consume(2, data, closed);
+}
@@ -0,0 +1,143 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: NUMA sub-queues
+    ==========================================
+
+    This example illustrates how `numa_enabled` can be used to give each
+    NUMA node its own sub-queue, so that producers stage their messages in
+    memory that is local to their node, and the consumer thread drains each
+    sub-queue in bulk. Since this example is meant to also run on single-node
+    machines, a fake two-node topology is provided through `numa_node_of_cpu`:
+    each producer declares its "node" in a thread-local variable, based on its
+    index. The consumer checks that each producer's messages are still
+    delivered in order.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_NODES (2)
+#define N_PRODUCERS (8)
+#define N_MESSAGES_PER_PRODUCER (1000)
+#define NUMA_QUEUE_CAPACITY (32)
+
+typedef struct
+{
+    size_t producer;
+    size_t value;
+} my_message_t;
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static int my_node_of_cpu(int cpu, void *context);
+
+static _Thread_local int my_fake_node = -1;
+static size_t n_node_lookups[N_NODES];
+static size_t next_values[N_PRODUCERS];
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(my_message_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .numa_enabled = true,
+        .numa_queue_capacity = NUMA_QUEUE_CAPACITY,
+        .numa_node_of_cpu = my_node_of_cpu,
+        .numa_n_nodes = N_NODES,
+        .numa_context = n_node_lookups,
+    });
+
+    size_t indices[N_PRODUCERS];
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        indices[i] = i;
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, &indices[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    // NOTE: Each producer's node is only looked up once, on its first send.
+    for (size_t i = 0; i < N_NODES; i++)
+    {
+        assert(n_node_lookups[i] == N_PRODUCERS / N_NODES);
+    }
+    fprintf(stdout, "[main] %zu messages were received, in order, from %d producers over %d sub-queues\n", n_received, N_PRODUCERS, N_NODES);
+
+    exit(EXIT_SUCCESS);
+}
+
+static int my_node_of_cpu(int cpu, void *context)
+{
+    IGNORE_UNUSED(cpu);
+    size_t *lookups = (size_t *)context;
+    assert(my_fake_node >= 0);
+    // NOTE: Called from the producer threads, hence the atomic increment.
+    __atomic_fetch_add(&lookups[my_fake_node], 1, __ATOMIC_RELAXED);
+    return my_fake_node;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(my_message_t));
+    my_message_t message;
+    memcpy(&message, data, n);
+    free(data);
+    assert(message.producer < N_PRODUCERS);
+    assert(message.value == next_values[message.producer]);
+    next_values[message.producer] += 1;
+    n_received += 1;
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    size_t index = *(size_t *)mpsc_producer_context(producer);
+    my_fake_node = (int)(index % N_NODES);
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        my_message_t message = {.producer = index, .value = i};
+        assert(mpsc_producer_send(producer, &message, sizeof(my_message_t)));
+    }
+}
@@ -0,0 +1,147 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==================================
+    Example: Chaining channels
+    ==================================
+
+    This example illustrates how `mpsc_connect` can be used to build a
+    two-stage pipeline without an intermediate thread. Producers send
+    numbers to the first stage, whose messages are squared in place
+    by `my_square_transform` (odd numbers are dropped) and then moved
+    directly into the second stage's internal buffer, whose consumer
+    callback computes the sum. Note how the first stage is joined before
+    the second one, since the first stage counts as a producer of the
+    second stage until it is closed.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (4)
+#define N_NUMBERS_PER_PRODUCER (1000)
+
+static bool my_square_transform(void *data, size_t *n, size_t capacity, void *context);
+static void my_first_stage_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_second_stage_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+static unsigned long long sum = 0;
+static size_t n_dropped = 0;
+
+int main(void)
+{
+    mpsc_t *first_stage = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(unsigned long long),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_first_stage_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+    mpsc_t *second_stage = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(unsigned long long),
+        .n_max_producers = 1,
+        .consumer_callback = my_second_stage_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+
+    assert(mpsc_connect(first_stage, second_stage, my_square_transform, &n_dropped) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(first_stage, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(first_stage);
+    mpsc_join(second_stage);
+
+    // NOTE: Each producer sends 1, 2, ..., N, and only the squares of the even numbers are kept.
+    unsigned long long expected = 0;
+    for (unsigned long long i = 2; i <= N_NUMBERS_PER_PRODUCER; i += 2)
+    {
+        expected += i * i;
+    }
+    expected *= N_PRODUCERS;
+    fprintf(stdout, "[main] sum = %llu (expected %llu), dropped = %zu\n", sum, expected, n_dropped);
+    assert(sum == expected);
+    assert(n_dropped == N_PRODUCERS * N_NUMBERS_PER_PRODUCER / 2);
+
+    exit(EXIT_SUCCESS);
+}
+
+static bool my_square_transform(void *data, size_t *n, size_t capacity, void *context)
+{
+    IGNORE_UNUSED(capacity);
+    assert(*n == sizeof(unsigned long long));
+    unsigned long long *value = data;
+    if (*value % 2 == 1)
+    {
+        // NOTE: The transform is always executed on the first stage's consumer thread.
+        *(size_t *)context += 1;
+        return false;
+    }
+    *value *= *value;
+    return true;
+}
+
+static void my_first_stage_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    IGNORE_UNUSED(data);
+    IGNORE_UNUSED(n);
+    // NOTE: Once connected, this callback only receives the "closed" call.
+    assert(closed);
+    fprintf(stdout, "[first stage] closed\n");
+}
+
+static void my_second_stage_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        fprintf(stdout, "[second stage] closed\n");
+        return;
+    }
+    assert(n == sizeof(unsigned long long));
+    sum += *(unsigned long long *)data;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (unsigned long long i = 1; i <= N_NUMBERS_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(unsigned long long)));
+    }
+}
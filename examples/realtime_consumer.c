@@ -0,0 +1,132 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Real-time consumer
+    ==========================================
+
+    This example illustrates how `realtime_enabled` can be used to create a
+    channel for bounded worst-case latency: the consumer thread runs with the
+    `SCHED_FIFO` policy, the channel's mutex uses priority inheritance, and the
+    channel's memory is prefaulted and locked at creation. The consumer callback
+    receives each message in an internal delivery buffer, which it doesn't free.
+
+    Since real-time scheduling and memory locking usually require privileges,
+    the channel is created with `error_handling_enabled = true`, and the example
+    reports (rather than fails on) an `EPERM`, `ENOMEM` or `EAGAIN` error.
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (4)
+#define N_MESSAGES_PER_PRODUCER (1000)
+#define CONSUMER_PRIORITY (10)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_consumer_error_callback(mpsc_consumer_t *consumer);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+static void *delivery_buffer = NULL;
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = my_consumer_error_callback,
+        .error_handling_enabled = true,
+        .create_and_join_thread_safety_disabled = false,
+        .realtime_enabled = true,
+        .realtime_priority = CONSUMER_PRIORITY,
+    });
+    if (mpsc == NULL)
+    {
+        assert(errno == EPERM || errno == ENOMEM || errno == EAGAIN);
+        fprintf(stdout, "[main] real-time mode is unavailable to this process (%s); try running with CAP_SYS_NICE and a larger RLIMIT_MEMLOCK\n", strerror(errno));
+        exit(EXIT_SUCCESS);
+    }
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    fprintf(stdout, "[main] %zu messages were delivered by a SCHED_FIFO consumer, without allocating\n", n_received);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    if (n_received == 0)
+    {
+        int policy;
+        struct sched_param sched_param;
+        assert(pthread_getschedparam(pthread_self(), &policy, &sched_param) == 0);
+        assert(policy == SCHED_FIFO);
+        assert(sched_param.sched_priority == CONSUMER_PRIORITY);
+        delivery_buffer = data;
+    }
+    // NOTE: Every message is delivered in the same (internal) buffer, which must not be freed.
+    assert(data == delivery_buffer);
+    assert(n == sizeof(size_t));
+    n_received += 1;
+}
+
+static void my_consumer_error_callback(mpsc_consumer_t *consumer)
+{
+    IGNORE_UNUSED(consumer);
+    // NOTE: In real-time mode, the consumer thread doesn't allocate memory, so this can't happen.
+    abort();
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
@@ -0,0 +1,111 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Recycled producer slots
+    ==========================================
+
+    This example illustrates how a long-running channel can be fed by many
+    short-lived producers, far more than `n_max_producers`. Once a producer's
+    thread callback function returns, its thread is joined (by the next call
+    to `mpsc_register_producer`) and its slot is reused, so that
+    `n_max_producers` only limits the number of producers that are running at
+    the same time. Here, the main thread keeps registering producers, backing
+    off whenever `MPSC_REGISTER_PRODUCER_ERROR_N_MAX_PRODUCERS_REACHED` is
+    returned.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_MAX_PRODUCERS (4)
+#define N_PRODUCERS (1000)
+#define N_MESSAGES_PER_PRODUCER (10)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = N_MAX_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+
+    size_t n_retries = 0;
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        mpsc_register_producer_error_t error;
+        while ((error = mpsc_register_producer(mpsc, my_producer_thread_callback, NULL)) == MPSC_REGISTER_PRODUCER_ERROR_N_MAX_PRODUCERS_REACHED)
+        {
+            n_retries += 1;
+            usleep(100);
+        }
+        assert(error == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    fprintf(
+        stdout,
+        "[main] %d producers (at most %d at a time) sent %zu messages; registration was retried %zu times\n",
+        N_PRODUCERS, N_MAX_PRODUCERS, n_received, n_retries);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(size_t));
+    n_received += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
@@ -0,0 +1,112 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Reusable channel
+    ==========================================
+
+    This example illustrates how a channel created with `reusable = true`
+    can be used to run many small fan-in jobs without paying for the
+    creation of a new channel (i.e., mutex, condition variables, consumer
+    thread, etc.) each time. For each job, producers are registered, the
+    channel is joined (which waits for all messages to be delivered), and
+    then `mpsc_reset` is called to make the channel usable again. Once done,
+    the channel is destroyed using `mpsc_destroy`.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_JOBS (1000)
+#define N_PRODUCERS (3)
+#define N_MESSAGES_PER_PRODUCER (10)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+static size_t n_received = 0;
+static size_t n_closed = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .reusable = true,
+    });
+
+    for (size_t job = 0; job < N_JOBS; job++)
+    {
+        if (job > 0)
+        {
+            mpsc_reset(mpsc);
+        }
+        for (size_t i = 0; i < N_PRODUCERS; i++)
+        {
+            assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+        }
+        mpsc_join(mpsc);
+        // NOTE: Once joined, every message of the job has been delivered.
+        assert(n_received == (job + 1) * N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+        assert(n_closed == job + 1);
+    }
+
+    mpsc_destroy(mpsc);
+
+    fprintf(stdout, "[main] %d jobs were run on the same channel (%zu messages)\n", N_JOBS, n_received);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        n_closed += 1;
+        return;
+    }
+    assert(n == sizeof(size_t));
+    n_received += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
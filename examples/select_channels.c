@@ -0,0 +1,149 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ===========================================
+    Example: Receiving from several channels
+    ===========================================
+
+    This example illustrates how channels created with
+    `pull_mode_enabled = true` can be consumed from a single
+    application thread using `mpsc_select`. The main thread waits on
+    a high-priority control channel and on a bulk data channel at the
+    same time: since the control channel comes first in the array,
+    its messages are always received before the pending bulk ones.
+    The channels are sealed (using `mpsc_seal`) so that they get
+    closed once their producers return, and each closed channel is
+    removed from the array passed to `mpsc_select`.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define N_BULK_PRODUCERS (4)
+#define N_BULK_MESSAGES_PER_PRODUCER (500)
+#define N_CONTROL_MESSAGES (5)
+#define CONTROL_INTERVAL_US (2000)
+#define SELECT_TIMEOUT_MS (100)
+
+static void my_bulk_producer_thread_callback(mpsc_producer_t *producer);
+static void my_control_producer_thread_callback(mpsc_producer_t *producer);
+
+int main(void)
+{
+    mpsc_t *control = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = 1,
+        .consumer_callback = NULL,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .pull_mode_enabled = true,
+    });
+    mpsc_t *bulk = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = N_BULK_PRODUCERS,
+        .consumer_callback = NULL,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .pull_mode_enabled = true,
+    });
+
+    assert(mpsc_register_producer(control, my_control_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    for (size_t i = 0; i < N_BULK_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(bulk, my_bulk_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+    mpsc_seal(control);
+    mpsc_seal(bulk);
+
+    mpsc_t *channels[2] = {control, bulk};
+    const char *names[2] = {"control", "bulk"};
+    size_t count = 2;
+    size_t n_received[2] = {0, 0};
+    size_t n_timeouts = 0;
+    while (count > 0)
+    {
+        size_t index;
+        void *data;
+        size_t n;
+        mpsc_receive_status_t status = mpsc_select(channels, count, SELECT_TIMEOUT_MS, &index, &data, &n);
+        if (status == MPSC_RECEIVE_STATUS_TIMEOUT)
+        {
+            n_timeouts += 1;
+            continue;
+        }
+        size_t channel_id = channels[index] == control ? 0 : 1;
+        if (status == MPSC_RECEIVE_STATUS_CLOSED)
+        {
+            fprintf(stdout, "[main] '%s' channel closed\n", names[channel_id]);
+            for (size_t i = index; i + 1 < count; i++)
+            {
+                channels[i] = channels[i + 1];
+            }
+            count -= 1;
+            continue;
+        }
+        assert(status == MPSC_RECEIVE_STATUS_MESSAGE);
+        assert(n == sizeof(size_t));
+        if (channel_id == 0)
+        {
+            fprintf(stdout, "[main] control message #%zu (after %zu bulk messages)\n", *(size_t *)data, n_received[1]);
+        }
+        n_received[channel_id] += 1;
+        free(data);
+    }
+
+    mpsc_join(control);
+    mpsc_join(bulk);
+
+    fprintf(stdout, "[main] received %zu control and %zu bulk messages (%zu timeout(s))\n", n_received[0], n_received[1], n_timeouts);
+    assert(n_received[0] == N_CONTROL_MESSAGES);
+    assert(n_received[1] == N_BULK_PRODUCERS * N_BULK_MESSAGES_PER_PRODUCER);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_bulk_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_BULK_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
+
+static void my_control_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 1; i <= N_CONTROL_MESSAGES; i++)
+    {
+        usleep(CONTROL_INTERVAL_US);
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
@@ -0,0 +1,159 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Shared consumer executor
+    ==========================================
+
+    This example illustrates how many channels can share a small pool of
+    consumer threads, by binding them to the same `mpsc_executor_t`
+    instance (instead of each channel spawning its own consumer thread).
+    Each of the `N_CHANNELS` channels is fed by `N_PRODUCERS_PER_CHANNEL`
+    producers, while only `N_EXECUTOR_THREADS` threads execute all of the
+    consumer callbacks. Since the callback of a given channel is never
+    executed concurrently with itself, the per-channel state below doesn't
+    need to be protected by a mutex.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_CHANNELS (64)
+#define N_PRODUCERS_PER_CHANNEL (2)
+#define N_MESSAGES_PER_PRODUCER (500)
+#define N_EXECUTOR_THREADS (2)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+struct my_message
+{
+    size_t channel_id;
+    size_t producer_id;
+    size_t sequence;
+};
+
+struct my_producer_thread_callback_context
+{
+    size_t channel_id;
+    size_t producer_id;
+};
+
+static size_t next_sequences[N_CHANNELS][N_PRODUCERS_PER_CHANNEL];
+
+int main(void)
+{
+    mpsc_executor_t *executor = mpsc_executor_create((mpsc_executor_create_params_t){
+        .n_threads = N_EXECUTOR_THREADS,
+        .error_handling_enabled = false,
+    });
+
+    mpsc_t *channels[N_CHANNELS];
+    struct my_producer_thread_callback_context contexts[N_CHANNELS][N_PRODUCERS_PER_CHANNEL];
+
+    for (size_t i = 0; i < N_CHANNELS; i++)
+    {
+        channels[i] = mpsc_create((mpsc_create_params_t){
+            .buffer_size = sizeof(struct my_message),
+            .n_max_producers = N_PRODUCERS_PER_CHANNEL,
+            .consumer_callback = my_consumer_callback,
+            .consumer_error_callback = NULL,
+            .error_handling_enabled = false,
+            .create_and_join_thread_safety_disabled = false,
+            .executor = executor,
+        });
+        for (size_t j = 0; j < N_PRODUCERS_PER_CHANNEL; j++)
+        {
+            contexts[i][j].channel_id = i;
+            contexts[i][j].producer_id = j;
+            assert(mpsc_register_producer(channels[i], my_producer_thread_callback, &contexts[i][j]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+        }
+    }
+
+    for (size_t i = 0; i < N_CHANNELS; i++)
+    {
+        mpsc_join(channels[i]);
+    }
+
+    // NOTE: All channels bound to the executor must have been joined before
+    // the executor can be destroyed.
+    mpsc_executor_destroy(executor);
+
+    for (size_t i = 0; i < N_CHANNELS; i++)
+    {
+        for (size_t j = 0; j < N_PRODUCERS_PER_CHANNEL; j++)
+        {
+            assert(next_sequences[i][j] == N_MESSAGES_PER_PRODUCER);
+        }
+    }
+    fprintf(
+        stdout,
+        "[main] %d channels delivered %d messages using %d consumer threads\n",
+        N_CHANNELS, N_CHANNELS * N_PRODUCERS_PER_CHANNEL * N_MESSAGES_PER_PRODUCER, N_EXECUTOR_THREADS);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    if (n != sizeof(struct my_message))
+    {
+        fprintf(stderr, "[consumer] Error: Unexpected message size\n");
+        exit(EXIT_FAILURE);
+    }
+    struct my_message *message = data;
+    size_t *next_sequence = &next_sequences[message->channel_id][message->producer_id];
+    if (message->sequence != *next_sequence)
+    {
+        fprintf(
+            stderr,
+            "[consumer] Error: expected message #%zu from producer %zu on channel %zu, got #%zu\n",
+            *next_sequence, message->producer_id, message->channel_id, message->sequence);
+        exit(EXIT_FAILURE);
+    }
+    *next_sequence += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    struct my_producer_thread_callback_context *ctx = mpsc_producer_context(producer);
+    for (size_t sequence = 0; sequence < N_MESSAGES_PER_PRODUCER; sequence++)
+    {
+        struct my_message message = {.channel_id = ctx->channel_id, .producer_id = ctx->producer_id, .sequence = sequence};
+        assert(mpsc_producer_send(producer, &message, sizeof(struct my_message)));
+    }
+}
@@ -0,0 +1,145 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Process-shared channel
+    ==========================================
+
+    This example illustrates how `process_shared` can be used to have producers
+    in separate (forked) worker processes feed a consumer running in the parent
+    process, through shared memory. Each worker process attaches its own producer
+    using `mpsc_shm_attach_producer`, tells the parent that it's ready (through a
+    pipe, so that the parent doesn't seal the channel too early), sends its
+    messages, and detaches its producer before exiting. The consumer checks that
+    each worker's messages are received in order.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_WORKERS (4)
+#define N_MESSAGES_PER_WORKER (10000)
+
+typedef struct
+{
+    size_t worker;
+    size_t value;
+} my_message_t;
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_worker_process(mpsc_t *mpsc, size_t worker, int ready_fd);
+
+static size_t next_values[N_WORKERS];
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(my_message_t),
+        .n_max_producers = N_WORKERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .process_shared = true,
+    });
+
+    int ready_pipe[2];
+    assert(pipe(ready_pipe) == 0);
+    pid_t pids[N_WORKERS];
+    for (size_t i = 0; i < N_WORKERS; i++)
+    {
+        pids[i] = fork();
+        assert(pids[i] >= 0);
+        if (pids[i] == 0)
+        {
+            close(ready_pipe[0]);
+            my_worker_process(mpsc, i, ready_pipe[1]);
+        }
+    }
+    close(ready_pipe[1]);
+
+    // NOTE: `mpsc_join` seals the channel, so we wait for all workers to be attached.
+    for (size_t i = 0; i < N_WORKERS; i++)
+    {
+        char ready;
+        assert(read(ready_pipe[0], &ready, 1) == 1);
+    }
+    close(ready_pipe[0]);
+
+    mpsc_join(mpsc);
+
+    for (size_t i = 0; i < N_WORKERS; i++)
+    {
+        int status;
+        assert(waitpid(pids[i], &status, 0) == pids[i]);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+    }
+    assert(n_received == N_WORKERS * N_MESSAGES_PER_WORKER);
+    fprintf(stdout, "[main] %zu messages were received, in order, from %d worker processes\n", n_received, N_WORKERS);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(my_message_t));
+    my_message_t *message = (my_message_t *)data;
+    assert(message->worker < N_WORKERS);
+    assert(message->value == next_values[message->worker]);
+    next_values[message->worker] += 1;
+    n_received += 1;
+    free(data);
+}
+
+static void my_worker_process(mpsc_t *mpsc, size_t worker, int ready_fd)
+{
+    mpsc_producer_t *producer;
+    assert(mpsc_shm_attach_producer(mpsc, &producer) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    assert(write(ready_fd, "", 1) == 1);
+    close(ready_fd);
+    for (size_t i = 0; i < N_MESSAGES_PER_WORKER; i++)
+    {
+        my_message_t message = {.worker = worker, .value = i};
+        assert(mpsc_producer_send(producer, &message, sizeof(my_message_t)));
+    }
+    mpsc_producer_detach(producer);
+    // NOTE: `_exit` skips the `atexit` handlers and stdio buffers inherited from the parent.
+    _exit(EXIT_SUCCESS);
+}
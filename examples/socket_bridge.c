@@ -0,0 +1,160 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Socket bridge
+    ==========================================
+
+    This example illustrates how `mpsc_bridge_create` can be used to accept
+    messages from producers running in other processes, which don't share any
+    memory with the consumer's process (e.g., sandboxed workers), over a local
+    datagram socket. Each worker process connects its own socket to the bridge's
+    path and sends one datagram per message. The bridge reads the datagrams in
+    batches and injects them into the channel, whose consumer checks that each
+    worker's messages are received in order. Each worker also sends a datagram
+    that doesn't fit in the channel's buffer, which the bridge drops and counts.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_WORKERS (4)
+#define N_MESSAGES_PER_WORKER (10000)
+#define BATCH_SIZE (32)
+
+typedef struct
+{
+    size_t worker;
+    size_t value;
+} my_message_t;
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_worker_process(const char *path, size_t worker);
+
+static size_t next_values[N_WORKERS];
+static size_t n_received = 0;
+
+int main(void)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/mpsc_socket_bridge.%ld.sock", (long)getpid());
+
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(my_message_t),
+        .n_max_producers = 1,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+    mpsc_bridge_t *bridge = mpsc_bridge_create(mpsc, (mpsc_bridge_create_params_t){
+        .path = path,
+        .batch_size = BATCH_SIZE,
+        .error_handling_enabled = false,
+    });
+
+    pid_t pids[N_WORKERS];
+    for (size_t i = 0; i < N_WORKERS; i++)
+    {
+        pids[i] = fork();
+        assert(pids[i] >= 0);
+        if (pids[i] == 0)
+        {
+            my_worker_process(path, i);
+        }
+    }
+    for (size_t i = 0; i < N_WORKERS; i++)
+    {
+        int status;
+        assert(waitpid(pids[i], &status, 0) == pids[i]);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+    }
+
+    // NOTE: The oversized datagrams might still be queued on the socket, so this
+    // waits for the bridge to read them.
+    while (mpsc_bridge_n_dropped_datagrams(bridge) < N_WORKERS)
+    {
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = 1000000}, NULL);
+    }
+
+    // NOTE: The datagrams that are still queued on the socket are delivered before this returns.
+    mpsc_bridge_destroy(bridge);
+    mpsc_join(mpsc);
+
+    assert(n_received == N_WORKERS * N_MESSAGES_PER_WORKER);
+    fprintf(stdout, "[main] %zu messages were received, in order, from %d worker processes over '%s'\n", n_received, N_WORKERS, path);
+    fprintf(stdout, "[main] %d oversized datagrams were dropped\n", N_WORKERS);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(my_message_t));
+    my_message_t *message = (my_message_t *)data;
+    assert(message->worker < N_WORKERS);
+    assert(message->value == next_values[message->worker]);
+    next_values[message->worker] += 1;
+    n_received += 1;
+    free(data);
+}
+
+static void my_worker_process(const char *path, size_t worker)
+{
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    assert(fd >= 0);
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    assert(connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+    // NOTE: Larger than the channel's `buffer_size`, so the bridge drops it.
+    my_message_t oversized[2] = {{.worker = worker, .value = 0}};
+    assert(send(fd, oversized, sizeof(oversized), 0) == (ssize_t)sizeof(oversized));
+    for (size_t i = 0; i < N_MESSAGES_PER_WORKER; i++)
+    {
+        my_message_t message = {.worker = worker, .value = i};
+        // NOTE: Blocks while the bridge's socket queue is full.
+        assert(send(fd, &message, sizeof(my_message_t), 0) == (ssize_t)sizeof(my_message_t));
+    }
+    close(fd);
+    _exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,144 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Spilling to disk
+    ==========================================
+
+    This example illustrates how `spill_directory` can be used to keep producers
+    from blocking while the consumer falls behind. The consumer callback stalls
+    for a while on the first message, during which producers keep sending, and
+    their messages are spilled to (small, to show that they get recycled) segment
+    files. The consumer then catches up, and checks that each producer's messages
+    were received in order.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define SPILL_DIRECTORY "/tmp"
+#define SPILL_SEGMENT_SIZE (4096)
+#define N_PRODUCERS (4)
+#define N_MESSAGES_PER_PRODUCER (10000)
+#define CONSUMER_STALL_MS (200)
+
+typedef struct
+{
+    uint64_t producer_index;
+    uint64_t sequence;
+} my_message_t;
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static uint64_t my_now_ms(void);
+
+static uint64_t next_sequences[N_PRODUCERS] = {0};
+static size_t n_received = 0;
+static uint64_t start_ms = 0;
+static uint64_t consumer_done_ms = 0;
+static uint64_t producers_done_ms[N_PRODUCERS] = {0};
+
+int main(void)
+{
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(my_message_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .spill_directory = SPILL_DIRECTORY,
+        .spill_segment_size = SPILL_SEGMENT_SIZE,
+    });
+
+    start_ms = my_now_ms();
+    static uint64_t producer_indices[N_PRODUCERS];
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        producer_indices[i] = i;
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, &producer_indices[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(next_sequences[i] == N_MESSAGES_PER_PRODUCER);
+        // NOTE: Producers never waited for the stalled consumer.
+        assert(producers_done_ms[i] - start_ms < CONSUMER_STALL_MS);
+        fprintf(stdout, "[main] producer %zu was done sending after %llu ms\n", i, (unsigned long long)(producers_done_ms[i] - start_ms));
+    }
+    fprintf(stdout, "[main] the consumer received all %zu messages, in order, after %llu ms\n", n_received, (unsigned long long)(consumer_done_ms - start_ms));
+
+    exit(EXIT_SUCCESS);
+}
+
+static uint64_t my_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        consumer_done_ms = my_now_ms();
+        return;
+    }
+    assert(n == sizeof(my_message_t));
+    my_message_t *message = (my_message_t *)data;
+    assert(message->sequence == next_sequences[message->producer_index]);
+    next_sequences[message->producer_index] += 1;
+    free(data);
+    if (n_received == 0)
+    {
+        // NOTE: Simulates a consumer hiccup.
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = CONSUMER_STALL_MS * 1000000L}, NULL);
+    }
+    n_received += 1;
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    uint64_t producer_index = *(uint64_t *)mpsc_producer_context(producer);
+    for (uint64_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        my_message_t message = {.producer_index = producer_index, .sequence = i};
+        assert(mpsc_producer_send(producer, &message, sizeof(my_message_t)));
+    }
+    producers_done_ms[producer_index] = my_now_ms();
+}
@@ -0,0 +1,105 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Caller-provided storage
+    ==========================================
+
+    This example illustrates how `mpsc_init` can be used to create a channel
+    inside of memory owned by the application (here, a static array sized using
+    `MPSC_STORAGE_SIZE`), instead of having `mpsc_create` allocate it from the
+    heap. Since the storage can be reused once `mpsc_join` has returned, the
+    same array is used for each of the `N_JOBS` short-lived channels.
+*/
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_JOBS (100)
+#define N_PRODUCERS (2)
+#define N_MESSAGES_PER_PRODUCER (50)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+
+static alignas(max_align_t) unsigned char storage[MPSC_STORAGE_SIZE(sizeof(size_t), N_PRODUCERS)];
+static size_t sum = 0;
+
+int main(void)
+{
+    size_t expected_sum = 0;
+    for (size_t job = 0; job < N_JOBS; job++)
+    {
+        mpsc_t *mpsc = mpsc_init(storage, sizeof(storage), (mpsc_create_params_t){
+            .buffer_size = sizeof(size_t),
+            .n_max_producers = N_PRODUCERS,
+            .consumer_callback = my_consumer_callback,
+            .consumer_error_callback = NULL,
+            .error_handling_enabled = false,
+            .create_and_join_thread_safety_disabled = false,
+        });
+        assert((void *)mpsc == (void *)storage);
+        for (size_t i = 0; i < N_PRODUCERS; i++)
+        {
+            assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+        }
+        // NOTE: Once joined, `storage` can be used for the next channel.
+        mpsc_join(mpsc);
+        expected_sum += N_PRODUCERS * (N_MESSAGES_PER_PRODUCER * (N_MESSAGES_PER_PRODUCER - 1) / 2);
+    }
+
+    assert(sum == expected_sum);
+    fprintf(stdout, "[main] %d channels were created inside of the same %zu bytes of static storage\n", N_JOBS, sizeof(storage));
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(size_t));
+    sum += *(size_t *)data;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
@@ -0,0 +1,140 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Channel statistics
+    ==========================================
+
+    This example illustrates how `mpsc_stats` can be used to see what a channel
+    is doing. The consumer callback is slower than the producers, so most sends
+    have to wait in the producers' wait queue, which shows up as a growing wait
+    time, and as a queue depth close to the number of producers. The main thread
+    samples the statistics while the producers are running, and the consumer
+    checks the final ones when the channel gets closed.
+*/
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (4)
+#define N_MESSAGES_PER_PRODUCER (200)
+#define CONSUMER_DELAY_US (200)
+#define N_SAMPLES (3)
+#define SAMPLE_INTERVAL_MS (40)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static void my_print_stats(const char *label, const mpsc_stats_t *stats);
+
+static mpsc_t *mpsc = NULL;
+
+int main(void)
+{
+    mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(uint64_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        // NOTE: Measures `wait_time_ns` and `consumer_busy_time_ns`, which stay at 0 otherwise.
+        .stats_timing_enabled = true,
+    });
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    for (size_t i = 0; i < N_SAMPLES; i++)
+    {
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = SAMPLE_INTERVAL_MS * 1000000L}, NULL);
+        mpsc_stats_t stats;
+        mpsc_stats(mpsc, &stats);
+        assert(stats.n_messages_delivered <= stats.n_messages_sent);
+        assert(stats.queue_depth <= stats.max_queue_depth);
+        my_print_stats("[main] while running:", &stats);
+    }
+
+    mpsc_join(mpsc);
+
+    exit(EXIT_SUCCESS);
+}
+
+static void my_print_stats(const char *label, const mpsc_stats_t *stats)
+{
+    fprintf(
+        stdout,
+        "%s sent = %" PRIu64 " (%" PRIu64 " bytes), delivered = %" PRIu64 " (%" PRIu64 " bytes), waited = %" PRIu64 " (%" PRIu64 " us), queue depth = %zu (max %zu), consumer busy = %" PRIu64 " us, wake-ups = %" PRIu64 " (consumer) / %" PRIu64 " (producers)\n",
+        label,
+        stats->n_messages_sent, stats->n_bytes_sent,
+        stats->n_messages_delivered, stats->n_bytes_delivered,
+        stats->n_sends_waited, stats->wait_time_ns / 1000u,
+        stats->queue_depth, stats->max_queue_depth,
+        stats->consumer_busy_time_ns / 1000u,
+        stats->n_consumer_wakeups, stats->n_producer_wakeups);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        // NOTE: The channel is only destroyed by `mpsc_join`, once this call returns.
+        mpsc_stats_t stats;
+        mpsc_stats(mpsc, &stats);
+        my_print_stats("[consumer] once closed:", &stats);
+        assert(stats.n_messages_sent == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+        assert(stats.n_bytes_sent == stats.n_messages_sent * sizeof(uint64_t));
+        assert(stats.n_messages_delivered == stats.n_messages_sent);
+        assert(stats.n_bytes_delivered == stats.n_bytes_sent);
+        assert(stats.queue_depth == 0);
+        // NOTE: The consumer is the bottleneck, so producers piled up in the wait queue.
+        assert(stats.n_sends_waited > 0);
+        assert(stats.max_queue_depth > 1 && stats.max_queue_depth <= N_PRODUCERS + 1);
+        assert(stats.consumer_busy_time_ns >= stats.n_messages_delivered * CONSUMER_DELAY_US * 1000u);
+        return;
+    }
+    assert(n == sizeof(uint64_t));
+    free(data);
+    nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = CONSUMER_DELAY_US * 1000L}, NULL);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (uint64_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(uint64_t)));
+    }
+}
@@ -0,0 +1,151 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Thread attributes
+    ==========================================
+
+    This example illustrates how `consumer_thread_attributes` and
+    `producer_thread_attributes` can be used to control the internal
+    threads' stack size, CPU affinity and name. The consumer thread is
+    pinned to the first CPU available to the process and named "mpsc-cons",
+    while the producer threads use small stacks, are named "mpsc-prod-N",
+    and are each pinned to a single CPU, in a round-robin fashion. Each
+    thread checks its own attributes (which would also be visible in tools
+    such as `top -H` or `perf top`).
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_PRODUCERS (8)
+#define N_MESSAGES_PER_PRODUCER (100)
+#define PRODUCER_STACK_SIZE (64 * 1024)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static int my_thread_cpu_count(void);
+
+static size_t n_received = 0;
+
+int main(void)
+{
+    cpu_set_t available;
+    assert(sched_getaffinity(0, sizeof(cpu_set_t), &available) == 0);
+    int cpus[CPU_SETSIZE];
+    size_t n_cpus = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &available))
+        {
+            cpus[n_cpus++] = cpu;
+        }
+    }
+
+    mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(size_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .consumer_thread_attributes = {
+            .cpus = cpus,
+            .n_cpus = 1,
+            .name = "mpsc-cons",
+        },
+        .producer_thread_attributes = {
+            .stack_size = PRODUCER_STACK_SIZE,
+            .cpus = cpus,
+            .n_cpus = n_cpus,
+            .cpus_round_robin = true,
+            .name = "mpsc-prod",
+        },
+    });
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+
+    mpsc_join(mpsc);
+
+    assert(n_received == N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    fprintf(stdout, "[main] %zu messages were sent by %d named and pinned producers over %zu CPU(s)\n", n_received, N_PRODUCERS, n_cpus);
+
+    exit(EXIT_SUCCESS);
+}
+
+static int my_thread_cpu_count(void)
+{
+    cpu_set_t cpus;
+    assert(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus) == 0);
+    return CPU_COUNT(&cpus);
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    if (n_received == 0)
+    {
+        char name[16];
+        assert(pthread_getname_np(pthread_self(), name, sizeof(name)) == 0);
+        assert(strcmp(name, "mpsc-cons") == 0);
+        assert(my_thread_cpu_count() == 1);
+        fprintf(stdout, "[consumer] running as '%s' on CPU %i\n", name, sched_getcpu());
+    }
+    assert(n == sizeof(size_t));
+    n_received += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    char name[16];
+    assert(pthread_getname_np(pthread_self(), name, sizeof(name)) == 0);
+    assert(strncmp(name, "mpsc-prod-", strlen("mpsc-prod-")) == 0);
+    assert(my_thread_cpu_count() == 1);
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
@@ -0,0 +1,123 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Thread cache
+    ==========================================
+
+    This example illustrates how `mpsc_thread_cache_configure` can be used
+    to have the consumer and producer threads of short-lived channels parked
+    and reused, instead of creating (and joining) new threads for each
+    channel. The same batch of `N_JOBS` small jobs is run twice, first with
+    the cache disabled (the default), and then with the cache enabled, and
+    the time taken by each batch is printed.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define N_JOBS (500)
+#define N_PRODUCERS (4)
+#define N_MESSAGES_PER_PRODUCER (5)
+#define MAX_IDLE_THREADS (N_PRODUCERS + 1)
+#define IDLE_TIMEOUT_MS (1000)
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static double run_jobs(void);
+
+static size_t n_received = 0;
+
+int main(void)
+{
+    double without_cache = run_jobs();
+
+    mpsc_thread_cache_configure((mpsc_thread_cache_params_t){
+        .max_idle_threads = MAX_IDLE_THREADS,
+        .idle_timeout_ms = IDLE_TIMEOUT_MS,
+    });
+    double with_cache = run_jobs();
+
+    // NOTE: Disables the cache, and waits for the parked threads to exit.
+    mpsc_thread_cache_drain();
+
+    assert(n_received == 2 * N_JOBS * N_PRODUCERS * N_MESSAGES_PER_PRODUCER);
+    fprintf(stdout, "[main] %d jobs without thread cache: %.3f ms\n", N_JOBS, without_cache);
+    fprintf(stdout, "[main] %d jobs with thread cache: %.3f ms\n", N_JOBS, with_cache);
+
+    exit(EXIT_SUCCESS);
+}
+
+static double run_jobs(void)
+{
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t job = 0; job < N_JOBS; job++)
+    {
+        mpsc_t *mpsc = mpsc_create((mpsc_create_params_t){
+            .buffer_size = sizeof(size_t),
+            .n_max_producers = N_PRODUCERS,
+            .consumer_callback = my_consumer_callback,
+            .consumer_error_callback = NULL,
+            .error_handling_enabled = false,
+            .create_and_join_thread_safety_disabled = false,
+        });
+        for (size_t i = 0; i < N_PRODUCERS; i++)
+        {
+            assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+        }
+        mpsc_join(mpsc);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(size_t));
+    n_received += 1;
+    free(data);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (size_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(size_t)));
+    }
+}
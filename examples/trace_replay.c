@@ -0,0 +1,167 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Recording and replaying traffic
+    ==========================================
+
+    This example illustrates how `mpsc_trace_start` can be used to record a
+    channel's traffic to a trace file, and how `mpsc_trace_replay` can then be
+    used to re-inject that traffic into another channel, at an accelerated speed,
+    as a benchmark would do to drive its consumer callback with a realistic load.
+    Producers send bursts of messages separated by pauses, and the replay checks
+    that each producer's messages are received again, in order, in about a
+    quarter of the original time.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define TRACE_PATH "/tmp/mpsc_trace_example.bin"
+#define N_PRODUCERS (3)
+#define N_BURSTS (10)
+#define N_MESSAGES_PER_BURST (50)
+#define PAUSE_BETWEEN_BURSTS_MS (20)
+#define SPEEDUP (4.0)
+
+typedef struct
+{
+    uint64_t producer_index;
+    uint64_t sequence;
+} my_message_t;
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static mpsc_t *my_create_channel(void);
+static double my_now_ms(void);
+
+static uint64_t next_sequences[N_PRODUCERS] = {0};
+static size_t n_received = 0;
+
+int main(void)
+{
+    mpsc_t *mpsc = my_create_channel();
+    mpsc_trace_t *trace = mpsc_trace_start(mpsc, (mpsc_trace_create_params_t){
+        .path = TRACE_PATH,
+        .payloads_enabled = true,
+        .error_handling_enabled = false,
+    });
+    double start_ms = my_now_ms();
+    static uint64_t producer_indices[N_PRODUCERS];
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        producer_indices[i] = i;
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, &producer_indices[i]) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+    // NOTE: Waits for the producers to be done before stopping the trace.
+    while (__atomic_load_n(&n_received, __ATOMIC_ACQUIRE) < N_PRODUCERS * N_BURSTS * N_MESSAGES_PER_BURST)
+    {
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = 1000000L}, NULL);
+    }
+    double recorded_ms = my_now_ms() - start_ms;
+    assert(mpsc_trace_stop(trace) == 0);
+    mpsc_join(mpsc);
+    fprintf(stdout, "[main] recorded %zu messages over %.1f ms\n", n_received, recorded_ms);
+
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        next_sequences[i] = 0;
+    }
+    n_received = 0;
+    mpsc = my_create_channel();
+    start_ms = my_now_ms();
+    assert(mpsc_trace_replay(mpsc, (mpsc_trace_replay_params_t){
+        .path = TRACE_PATH,
+        .speedup = SPEEDUP,
+        .error_handling_enabled = false,
+    }));
+    double replayed_ms = my_now_ms() - start_ms;
+    mpsc_join(mpsc);
+    assert(n_received == N_PRODUCERS * N_BURSTS * N_MESSAGES_PER_BURST);
+    fprintf(stdout, "[main] replayed %zu messages, in order, over %.1f ms (%.1fx faster)\n", n_received, replayed_ms, SPEEDUP);
+
+    unlink(TRACE_PATH);
+    exit(EXIT_SUCCESS);
+}
+
+static mpsc_t *my_create_channel(void)
+{
+    return mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(my_message_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = my_consumer_callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+    });
+}
+
+static double my_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+static void my_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    IGNORE_UNUSED(consumer);
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(my_message_t));
+    my_message_t *message = (my_message_t *)data;
+    assert(message->sequence == next_sequences[message->producer_index]);
+    next_sequences[message->producer_index] += 1;
+    free(data);
+    __atomic_add_fetch(&n_received, 1, __ATOMIC_RELEASE);
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    uint64_t producer_index = *(uint64_t *)mpsc_producer_context(producer);
+    uint64_t sequence = 0;
+    for (size_t burst = 0; burst < N_BURSTS; burst++)
+    {
+        for (size_t i = 0; i < N_MESSAGES_PER_BURST; i++)
+        {
+            my_message_t message = {.producer_index = producer_index, .sequence = sequence};
+            assert(mpsc_producer_send(producer, &message, sizeof(my_message_t)));
+            sequence += 1;
+        }
+        nanosleep(&(struct timespec){.tv_sec = 0, .tv_nsec = PAUSE_BETWEEN_BURSTS_MS * 1000000L}, NULL);
+    }
+}
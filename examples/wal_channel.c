@@ -0,0 +1,174 @@
+/*
+    Copyright (c) 2024 BB-301 <fw3dg3@gmail.com>
+    [Official repository](https://github.com/BB-301/c-mpsc)
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+/*
+    ==========================================
+    Example: Durable channel
+    ==========================================
+
+    This example illustrates how `wal_path` can be used to make a channel durable.
+    A first channel receives messages from a few producers (whose concurrent sends
+    share log syncs), but its consumer only acknowledges (using `mpsc_consumer_ack`)
+    the first half of them, as if the process had crashed halfway through. A second
+    channel is then created with the same log, and its consumer receives the other
+    half again, before any new message, and acknowledges everything. The log is
+    only truncated once it has grown past `MPSC_WAL_TRUNCATE_SIZE` (1 MiB by
+    default), so this small one keeps its records until the next channel compacts
+    it.
+*/
+
+#include <assert.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mpsc.h"
+
+#define IGNORE_UNUSED(m) ((void)(m))
+
+#define WAL_PATH "/tmp/mpsc_wal_example.log"
+#define N_PRODUCERS (4)
+#define N_MESSAGES_PER_PRODUCER (250)
+#define N_MESSAGES (N_PRODUCERS * N_MESSAGES_PER_PRODUCER)
+#define N_ACKNOWLEDGED (N_MESSAGES / 2)
+
+static void my_first_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_second_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
+static void my_producer_thread_callback(mpsc_producer_t *producer);
+static mpsc_t *my_create_channel(mpsc_consumer_callback_t *callback);
+static double my_now_ms(void);
+
+static size_t n_received = 0;
+static size_t n_replayed = 0;
+static uint64_t last_sequence = 0;
+
+int main(void)
+{
+    unlink(WAL_PATH);
+
+    mpsc_t *mpsc = my_create_channel(my_first_consumer_callback);
+    double start_ms = my_now_ms();
+    for (size_t i = 0; i < N_PRODUCERS; i++)
+    {
+        assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    }
+    mpsc_join(mpsc);
+    assert(n_received == N_MESSAGES);
+    fprintf(stdout, "[main] %zu durable messages were sent in %.1f ms, and %i of them were acknowledged\n", n_received, my_now_ms() - start_ms, N_ACKNOWLEDGED);
+
+    // NOTE: The new channel first delivers the messages that weren't acknowledged,
+    // and then the one sent by the producer below.
+    n_received = 0;
+    mpsc = my_create_channel(my_second_consumer_callback);
+    assert(mpsc_register_producer(mpsc, my_producer_thread_callback, NULL) == MPSC_REGISTER_PRODUCER_ERROR_NONE);
+    mpsc_join(mpsc);
+    assert(n_replayed == N_MESSAGES - N_ACKNOWLEDGED);
+    assert(n_received == n_replayed + N_MESSAGES_PER_PRODUCER);
+    fprintf(stdout, "[main] %zu messages were replayed, before %i new ones\n", n_replayed, N_MESSAGES_PER_PRODUCER);
+
+    struct stat wal_stat;
+    assert(stat(WAL_PATH, &wal_stat) == 0);
+    fprintf(stdout, "[main] the log holds %lld bytes once everything was acknowledged\n", (long long)wal_stat.st_size);
+
+    unlink(WAL_PATH);
+    exit(EXIT_SUCCESS);
+}
+
+static mpsc_t *my_create_channel(mpsc_consumer_callback_t *callback)
+{
+    return mpsc_create((mpsc_create_params_t){
+        .buffer_size = sizeof(uint64_t),
+        .n_max_producers = N_PRODUCERS,
+        .consumer_callback = callback,
+        .consumer_error_callback = NULL,
+        .error_handling_enabled = false,
+        .create_and_join_thread_safety_disabled = false,
+        .wal_path = WAL_PATH,
+    });
+}
+
+static double my_now_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+static void my_first_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(uint64_t));
+    free(data);
+    uint64_t sequence = mpsc_consumer_sequence(consumer);
+    assert(sequence == last_sequence + 1);
+    last_sequence = sequence;
+    n_received += 1;
+    if (n_received <= N_ACKNOWLEDGED)
+    {
+        mpsc_consumer_ack(consumer, sequence);
+    }
+}
+
+static void my_second_consumer_callback(mpsc_consumer_t *consumer, void *data, size_t n, bool closed)
+{
+    if (closed)
+    {
+        return;
+    }
+    assert(n == sizeof(uint64_t));
+    free(data);
+    uint64_t sequence = mpsc_consumer_sequence(consumer);
+    if (sequence <= N_MESSAGES)
+    {
+        // NOTE: Replayed messages keep their sequence number.
+        assert(sequence == N_ACKNOWLEDGED + n_replayed + 1);
+        n_replayed += 1;
+    }
+    else
+    {
+        assert(sequence == N_MESSAGES + n_received - n_replayed + 1);
+    }
+    n_received += 1;
+    // NOTE: Acknowledging every few messages is enough, since acknowledgements are cumulative.
+    if (n_received % 100 == 0 || n_received == N_MESSAGES - N_ACKNOWLEDGED + N_MESSAGES_PER_PRODUCER)
+    {
+        mpsc_consumer_ack(consumer, sequence);
+    }
+}
+
+static void my_producer_thread_callback(mpsc_producer_t *producer)
+{
+    for (uint64_t i = 0; i < N_MESSAGES_PER_PRODUCER; i++)
+    {
+        assert(mpsc_producer_send(producer, &i, sizeof(uint64_t)));
+    }
+}
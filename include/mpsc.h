@@ -31,6 +31,8 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
 
 /**
  * @brief The type returned by \ref mpsc_register_producer (as well as by its
@@ -62,9 +64,58 @@ typedef enum
      * @note When \ref mpsc_create_params_t 's `error_handling_enabled` is set to `false`,
      * this error will not be returned and will instead result in the process being terminated.
      */
-    MPSC_REGISTER_PRODUCER_ERROR_EAGAIN = 3
+    MPSC_REGISTER_PRODUCER_ERROR_EAGAIN = 3,
+    /**
+     * @brief The producer could not be registered because a \ref ENOMEM error was
+     * observed when, internally, while trying to allocate the state for a new chunk of producers.
+     * @note When \ref mpsc_create_params_t 's `error_handling_enabled` is set to `false`,
+     * this error will not be returned and will instead result in the process being terminated.
+     */
+    MPSC_REGISTER_PRODUCER_ERROR_ENOMEM = 4,
+    /**
+     * @brief The file descriptor source could not be registered because a limit on the number of file
+     * descriptors (i.e., \ref EMFILE or \ref ENFILE ) or of `epoll` watches (i.e., \ref ENOSPC ) was reached,
+     * internally, while trying to poll it (see \ref mpsc_register_fd_source ).
+     * @note When \ref mpsc_create_params_t 's `error_handling_enabled` is set to `false`,
+     * this error will not be returned and will instead result in the process being terminated.
+     */
+    MPSC_REGISTER_PRODUCER_ERROR_EMFILE = 5,
+    /**
+     * @brief The file descriptor source could not be registered because its file descriptor can't be
+     * polled (e.g., it refers to a regular file, or it has already been registered), as reported by `epoll_ctl`
+     * (see \ref mpsc_register_fd_source ).
+     */
+    MPSC_REGISTER_PRODUCER_ERROR_INVALID_FD = 6
 } mpsc_register_producer_error_t;
 
+/**
+ * @brief The type returned by \ref mpsc_receive and \ref mpsc_select , which are used to receive
+ * messages from channels created with \ref mpsc_create_params_t 's `pull_mode_enabled = true`.
+ * @see mpsc_receive, mpsc_select
+ */
+typedef enum
+{
+    /**
+     * @brief A message was received.
+     */
+    MPSC_RECEIVE_STATUS_MESSAGE = 0,
+    /**
+     * @brief No message was received before the timeout expired.
+     */
+    MPSC_RECEIVE_STATUS_TIMEOUT = 1,
+    /**
+     * @brief The channel has been closed and all of its messages have been received.
+     */
+    MPSC_RECEIVE_STATUS_CLOSED = 2,
+    /**
+     * @brief The memory needed to hold a copy of the message could not be allocated (i.e.,
+     * \ref errno is set to \ref ENOMEM ). The message is left inside the channel, so that it
+     * can be received by a subsequent call. This can only be returned when
+     * \ref mpsc_create_params_t 's `error_handling_enabled` is set to `true`.
+     */
+    MPSC_RECEIVE_STATUS_ERROR = 3
+} mpsc_receive_status_t;
+
 /**
  * @brief An opaque data type used as a container for the MPSC channel data.
  * @see mpsc_create, mpsc_join
@@ -73,6 +124,32 @@ typedef enum
  */
 typedef struct mpsc_s mpsc_t;
 
+/**
+ * @brief An opaque data type used as a container for a pool of threads shared by
+ * several \ref mpsc_t instances to execute their consumer callbacks.
+ * @see mpsc_executor_create, mpsc_executor_destroy, mpsc_create_params_t
+ */
+typedef struct mpsc_executor_s mpsc_executor_t;
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_executor_create to instantiate
+ * a new \ref mpsc_executor_t object.
+ */
+typedef struct
+{
+    /**
+     * @brief The number of threads in the pool.
+     * @note This value must be greater than 0, else the process will be terminated.
+     */
+    size_t n_threads;
+    /**
+     * @brief A boolean value indicating whether resources exhaustion errors in
+     * \ref mpsc_executor_create should be handed over to the application (i.e., \ref NULL
+     * is returned and \ref errno is set) or whether the process should be terminated.
+     */
+    bool error_handling_enabled;
+} mpsc_executor_create_params_t;
+
 /**
  * @brief An opaque data type used as a container for the MPSC channel's
  * consumer.
@@ -119,6 +196,12 @@ typedef void(mpsc_producer_thread_callback_t)(mpsc_producer_t *producer);
  Blocking tasks, if required, should be offloaded to other threads and the callback should return
  as quick as possible.
  * @note - When \p n is set to 0, \p data will be set to \ref NULL .
+ * @note - When \ref mpsc_create_params_t 's `realtime_enabled` is `true`, \p data instead points
+ * to an internal delivery buffer, which must not be freed, and which is only valid until the callback returns.
+ * @note - When \ref mpsc_create_params_t 's `n_dispatch_workers` is non-zero, the callback
+ * is executed on the dispatch worker thread that owns the message's key (see \ref mpsc_producer_send_keyed ),
+ * which means that it can be executed concurrently for messages having different keys. The final call
+ * with `closed = true` is still made only once, after all dispatch workers have returned.
  */
 typedef void(mpsc_consumer_callback_t)(mpsc_consumer_t *consumer, void *data, size_t n, bool closed);
 
@@ -136,6 +219,92 @@ typedef void(mpsc_consumer_callback_t)(mpsc_consumer_t *consumer, void *data, si
  */
 typedef void(mpsc_consumer_error_callback_t)(mpsc_consumer_t *consumer);
 
+/**
+ * @brief The signature of an optional transform callback function, to be declared and implemented
+ * by the application, which is passed as a parameter to \ref mpsc_connect .
+ * @param data A pointer to the upstream channel's internal buffer, which contains the message and can
+ * be modified in place. It is valid only for the duration of the call.
+ * @param n A pointer to the message size (in bytes), which can be updated if the transformed message
+ * has a different size.
+ * @param capacity The size (in bytes) of \p data (i.e., the upstream channel's `buffer_size`), which is
+ * the upper bound of the transformed message size.
+ * @param context The application defined context passed to \ref mpsc_connect .
+ * @return \ref bool `true` if the (possibly transformed) message should be forwarded to the downstream
+ * channel, or `false` if it should be dropped.
+ * @warning The transformed message size must not be greater than the downstream channel's `buffer_size`,
+ * else the process will be terminated.
+ * @see mpsc_connect
+ */
+typedef bool(mpsc_transform_callback_t)(void *data, size_t *n, size_t capacity, void *context);
+
+/**
+ * @brief The interface for an application defined function, which is passed as a parameter to
+ * \ref mpsc_register_fd_source , and used to split the bytes read from a file descriptor into messages.
+ * @param data A pointer to the bytes that have been read from the file descriptor, but that haven't
+ * been consumed yet.
+ * @param n The number of bytes pointed to by \p data .
+ * @param message_offset Set to the offset (in \p data ) of the first message, when one is complete.
+ * @param message_size Set to the size of the first message, when one is complete, which must not be
+ * greater than the channel's `buffer_size`.
+ * @param context The application defined context passed to \ref mpsc_register_fd_source .
+ * @return \ref size_t The number of bytes consumed by the first message (i.e., including any framing, such as
+ * a length prefix or a delimiter), or 0 if \p data doesn't contain a complete message yet.
+ * @warning The process will be terminated if the returned values don't describe a message inside of
+ * the consumed bytes (i.e., `message_offset + message_size` must not be greater than the returned value).
+ * @see mpsc_register_fd_source
+ */
+typedef size_t(mpsc_framing_callback_t)(const void *data, size_t n, size_t *message_offset, size_t *message_size, void *context);
+
+/**
+ * @brief The interface for an optional, application defined function used by NUMA mode (see
+ * \ref mpsc_create_params_t 's `numa_enabled`) to map a CPU index to a NUMA node index, which can be
+ * used to provide a fake topology (e.g., for testing on single-node machines).
+ * @param cpu The index of the CPU on which the calling producer thread is running.
+ * @param context The application defined context (i.e., \ref mpsc_create_params_t 's `numa_context`).
+ * @return int The index of the NUMA node, which must be less than `numa_n_nodes`.
+ * @note - This function is called from the producer's thread, the first time that it sends a message.
+ */
+typedef int(mpsc_numa_node_of_cpu_callback_t)(int cpu, void *context);
+
+/**
+ * @brief The attributes with which an internal thread is created (see \ref mpsc_create_params_t 's
+ * `consumer_thread_attributes` and `producer_thread_attributes`). All fields are optional: a zero
+ * initialized structure means that the system's defaults are used.
+ */
+typedef struct
+{
+    /**
+     * @brief The thread's stack size, in bytes, or 0 for the system's default.
+     * @note - When non-zero, this value must be at least \ref PTHREAD_STACK_MIN , else the
+     * process will be terminated.
+     */
+    size_t stack_size;
+    /**
+     * @brief An optional (i.e., can be \ref NULL ) array of CPU indexes on which the thread is allowed to run.
+     * @note - The array is copied, so it doesn't need to remain valid after the call to \ref mpsc_create .
+     * @note - CPU affinity is only supported on Linux; elsewhere, a non-empty array terminates the process.
+     */
+    const int *cpus;
+    /**
+     * @brief The number of elements in `cpus`.
+     */
+    size_t n_cpus;
+    /**
+     * @brief A boolean value indicating whether each producer thread should instead be pinned to a
+     * single CPU from `cpus`, chosen in a round-robin fashion using the producer's slot index.
+     * @note - This value is ignored for the consumer thread.
+     */
+    bool cpus_round_robin;
+    /**
+     * @brief An optional (i.e., can be \ref NULL ) name for the thread (e.g., `"mpsc-cons"`), which is
+     * visible in tools like `top` and `perf`. Producer threads get their slot index appended to it (e.g.,
+     * `"mpsc-prod-3"`).
+     * @note - Linux limits thread names to 15 characters, so longer names are truncated.
+     * @note - Thread names are only supported on Linux; elsewhere, a non-NULL name terminates the process.
+     */
+    const char *name;
+} mpsc_thread_attributes_t;
+
 /**
  * @brief The structure that must be passed to \ref mpsc_create to instantiate
  * a new \ref mpsc_t object.
@@ -163,12 +332,18 @@ typedef struct
     size_t buffer_size;
     /**
      * @brief The maximum number of producers that can be registered
-     * on the \ref mpsc_t instance.
+     * on the \ref mpsc_t instance at the same time.
      * @note - This value must be greater than 0, else the process will
      * be terminated.
      * @note - Calling \ref mpsc_register_producer when this value has
      * been reached will result in a \ref mpsc_register_producer_error_t
      * error of type \ref MPSC_REGISTER_PRODUCER_ERROR_N_MAX_PRODUCERS_REACHED .
+     * @note - A producer stops counting towards this value once it's finished (i.e.,
+     * once its thread callback function has returned, or once it has been detached),
+     * since its thread is then joined and its slot reused by the next registration.
+     * @note - This value is only a ceiling: the per-producer state is allocated in
+     * chunks, as producers are registered, so a large value doesn't make \ref mpsc_create
+     * any more expensive.
      */
     size_t n_max_producers;
     /**
@@ -209,6 +384,224 @@ typedef struct
      * distinct threads for the same \ref mpsc_t instance.
      */
     bool create_and_join_thread_safety_disabled;
+    /**
+     * @brief The number of dispatch worker threads to be used for key-ordered parallel
+     * delivery, or 0 (the default) to deliver all messages on the internal consumer thread.
+     * @note - When non-zero, the internal consumer thread no longer executes `consumer_callback`
+     * itself. Instead, it routes each message to the worker whose index is the message's key
+     * hash modulo `n_dispatch_workers` (see \ref mpsc_producer_send_keyed ), and that worker
+     * executes `consumer_callback`. Messages sharing a key are therefore delivered in the
+     * order in which they were accepted by the channel, while messages with different keys
+     * can be processed in parallel.
+     * @note - Messages sent using \ref mpsc_producer_send or \ref mpsc_producer_send_empty
+     * use a key hash of 0.
+     */
+    size_t n_dispatch_workers;
+    /**
+     * @brief The maximum number of messages that can be queued for each dispatch worker.
+     * @note - This value must be greater than 0 when `n_dispatch_workers` is non-zero, else
+     * the process will be terminated. It is ignored otherwise.
+     * @note - When the queue of the worker owning a message's key is full, the internal
+     * consumer thread waits for that worker to make room before picking up the next message,
+     * which means that producers calling \ref mpsc_producer_send will block as well (i.e.,
+     * backpressure is propagated into the channel).
+     */
+    size_t dispatch_queue_capacity;
+    /**
+     * @brief A boolean value indicating whether the channel should be created without an internal
+     * consumer thread, in which case the application receives the messages itself (i.e., "pulls" them)
+     * using \ref mpsc_receive or \ref mpsc_select , on any thread.
+     * @note - When `true`, `consumer_callback` is ignored (and can be \ref NULL ), and `n_dispatch_workers`
+     * must be 0, else the process will be terminated.
+     * @note - Since \ref mpsc_join waits for the channel to be closed, the application should call
+     * \ref mpsc_seal and receive messages until \ref MPSC_RECEIVE_STATUS_CLOSED is returned before
+     * calling \ref mpsc_join on the receiving thread.
+     */
+    bool pull_mode_enabled;
+    /**
+     * @brief An optional (i.e., can be \ref NULL ) \ref mpsc_executor_t instance to which the channel
+     * should be bound, in which case no internal consumer thread is created for the channel, and
+     * `consumer_callback` is instead executed by one of the executor's threads.
+     * @note - The calls to `consumer_callback` remain serialized for a given channel (i.e., they are
+     * never executed concurrently, and they are made in the order in which the messages were
+     * accepted), although consecutive calls can be made from different executor threads.
+     * @note - Since the executor's threads are shared, `consumer_callback` should never block.
+     * @note - `n_dispatch_workers` must be 0 and `pull_mode_enabled` must be `false` when an
+     * executor is used, else the process will be terminated.
+     */
+    mpsc_executor_t *executor;
+    /**
+     * @brief A boolean value indicating whether the channel can be reused once joined. When `true`,
+     * \ref mpsc_join drains and quiesces the channel, but keeps its resources (including its internal
+     * consumer thread, which is parked), so that \ref mpsc_reset can then return it to an open state.
+     * @note - A reusable channel must eventually be destroyed using \ref mpsc_destroy .
+     * @note - `n_dispatch_workers` must be 0 when `true`, else the process will be terminated.
+     */
+    bool reusable;
+    /**
+     * @brief The attributes (see \ref mpsc_thread_attributes_t ) of the internal consumer thread.
+     * @note - Ignored when no consumer thread is created (i.e., with `pull_mode_enabled = true` or
+     * with an `executor`).
+     */
+    mpsc_thread_attributes_t consumer_thread_attributes;
+    /**
+     * @brief A boolean value indicating whether the channel should use NUMA mode, in which each NUMA
+     * node gets its own sub-queue (whose memory is first touched by a producer on that node), so that
+     * producers stage messages on their own node instead of writing to the single internal buffer. The
+     * consumer thread then drains each sub-queue in bulk.
+     * @note - A producer's node is determined the first time it sends a message, and kept afterwards,
+     * so that the messages sent by a given producer are still delivered in order.
+     * @note - When `true`, `numa_queue_capacity` must be greater than 0, and `pull_mode_enabled`, `executor`,
+     * `n_dispatch_workers` and `reusable` must be left to their default values, else the process will be
+     * terminated. Such a channel can't be used with \ref mpsc_send_any , or as the upstream channel
+     * of \ref mpsc_connect .
+     * @note - NUMA mode is only supported on Linux; elsewhere, `true` terminates the process.
+     */
+    bool numa_enabled;
+    /**
+     * @brief The maximum number of messages that can be staged in each node's sub-queue, before
+     * producers on that node have to wait for the consumer thread to drain it.
+     */
+    size_t numa_queue_capacity;
+    /**
+     * @brief An optional (i.e., can be \ref NULL ) function used to map CPUs to NUMA nodes. When \ref NULL ,
+     * the topology is read from `/sys/devices/system/node` (a single node is assumed if unavailable).
+     * @note - When set, `numa_n_nodes` must be greater than 0, else the process will be terminated.
+     */
+    mpsc_numa_node_of_cpu_callback_t *numa_node_of_cpu;
+    /**
+     * @brief The number of NUMA nodes returned by `numa_node_of_cpu` (ignored when it's \ref NULL ).
+     */
+    size_t numa_n_nodes;
+    /**
+     * @brief An optional application defined context passed to `numa_node_of_cpu`.
+     */
+    void *numa_context;
+    /**
+     * @brief A boolean value indicating whether the channel should be created for bounded worst-case
+     * latency, in which case: (1) the consumer thread is created with the `SCHED_FIFO` scheduling policy
+     * and the `realtime_priority` priority; (2) the channel's mutex uses priority inheritance (i.e.,
+     * `PTHREAD_PRIO_INHERIT`), so that a lower priority producer holding it can't indefinitely delay the
+     * consumer thread; (3) the channel object, all `n_max_producers` producer slots and the message buffers
+     * are allocated at once, prefaulted and locked in memory (i.e., `mlock`); and (4) the consumer thread
+     * never allocates memory to deliver messages (see \ref mpsc_consumer_callback_t ).
+     * @note - Creating `SCHED_FIFO` threads and locking memory usually require privileges (e.g.,
+     * `CAP_SYS_NICE` and a large enough `RLIMIT_MEMLOCK`). When `error_handling_enabled = true`, such failures
+     * are reported by \ref mpsc_create through \ref errno (i.e., \ref EPERM , \ref ENOMEM or \ref EAGAIN ).
+     * @note - When `true`, `pull_mode_enabled`, `executor`, `n_dispatch_workers` and `numa_enabled` must be left
+     * to their default values, and the channel must be created using \ref mpsc_create (not \ref mpsc_init ),
+     * else the process will be terminated.
+     * @note - On platforms without priority inheritance mutexes (i.e., `_POSIX_THREAD_PRIO_INHERIT`),
+     * `true` terminates the process.
+     */
+    bool realtime_enabled;
+    /**
+     * @brief The consumer thread's `SCHED_FIFO` priority, when `realtime_enabled = true`, which must be
+     * within `sched_get_priority_min(SCHED_FIFO)` and `sched_get_priority_max(SCHED_FIFO)`.
+     */
+    int realtime_priority;
+    /**
+     * @brief A boolean value indicating whether the consumer thread should busy-poll the channel (i.e.,
+     * spin on it, using the CPU's pause instruction) while waiting for messages, instead of sleeping on a
+     * condition variable, which avoids the wake-up latency when a CPU is dedicated to the consumer thread
+     * (see `consumer_thread_attributes`). Producers don't signal a polling consumer thread.
+     * @note - When `true`, `pull_mode_enabled`, `executor` and `numa_enabled` must be left to their default
+     * values, else the process will be terminated.
+     */
+    bool busy_poll_enabled;
+    /**
+     * @brief The number of microseconds after which a busy-polling consumer thread that hasn't seen any
+     * message parks (i.e., sleeps until the next message, as it would without busy polling). It resumes
+     * polling after the next message. The value 0 means that the consumer thread never parks.
+     */
+    long busy_poll_idle_timeout_us;
+    /**
+     * @brief A boolean value indicating whether the internal message buffer should be backed by huge pages,
+     * which reduces TLB misses when `buffer_size` is large (e.g., in the megabytes). The buffer is taken from
+     * the hugetlbfs pool (i.e., `MAP_HUGETLB`) when pages are available there, else it's aligned on a huge page
+     * boundary and marked for transparent huge pages (i.e., `madvise(MADV_HUGEPAGE)`), and it's allocated using
+     * \ref malloc if neither is possible (e.g., on platforms other than Linux, which lack both).
+     * @note - When `realtime_enabled = true`, the whole real-time mapping is marked for transparent huge pages.
+     * @note - Must be `false` when using \ref mpsc_init , else the process will be terminated.
+     */
+    bool huge_pages_enabled;
+    /**
+     * @brief A boolean value indicating whether the channel should be shared with child processes, in
+     * which case the channel object, its producer slots and its message buffer are placed in a shared memory
+     * mapping (i.e., `memfd_create` and `MAP_SHARED` on Linux, else an anonymous `MAP_SHARED` mapping), and its mutex and condition variables are initialized
+     * as process-shared. Processes forked (after the call to \ref mpsc_create ) by the process that created
+     * the channel can then attach producers using \ref mpsc_shm_attach_producer , and send messages using the
+     * regular send functions, while the consumer thread (and the consumer callback) runs in the creating process.
+     * @note - Since the mapping is inherited by \ref fork , it has the same address in all processes, so
+     * child processes must be forked from the creating process (or its descendants), not started independently.
+     * @note - When `true`, `pull_mode_enabled`, `executor`, `n_dispatch_workers`, `reusable`, `numa_enabled`,
+     * `realtime_enabled` and `huge_pages_enabled` must be left to their default values, and the channel must be
+     * created using \ref mpsc_create (not \ref mpsc_init ), else the process will be terminated. Such a channel
+     * can't be used with \ref mpsc_send_any , or as either end of \ref mpsc_connect .
+     * @note - A process that exits while holding the channel's lock (i.e., while inside of a send function)
+     * leaves the channel unusable.
+     */
+    bool process_shared;
+    /**
+     * @brief The path of an existing directory in which messages are spilled when the consumer falls behind,
+     * or `NULL` (the default) to disable spilling. When set, a message that would have to wait for the internal
+     * buffer is instead appended to a memory-mapped segment file, and the send function returns right away. The
+     * consumer thread delivers spilled messages, in order, once the internal buffer is empty, and messages sent
+     * while some are still spilled are spilled as well, so that producers never overtake spilled messages.
+     * @note - Segment files are created (using `mkstemp`) and unlinked right away, so they never outlive
+     * the process. Their blocks are allocated upfront, and fully read segments are recycled.
+     * @note - When a message can't be spilled (e.g., because the disk is full), the producer waits for the
+     * spilled messages to be delivered, and then sends the message as it would without spilling.
+     * @note - When set, `pull_mode_enabled`, `executor`, `reusable`, `numa_enabled`, `realtime_enabled` and
+     * `process_shared` must be left to their default values, else the process will be terminated. Such a channel
+     * can't be used as the upstream end of \ref mpsc_connect .
+     */
+    const char *spill_directory;
+    /**
+     * @brief The size of each spill segment file, in bytes. The value 0 (the default) means
+     * `MPSC_SPILL_SEGMENT_SIZE` (16 MiB, unless overridden at compile time).
+     * @note - Must leave room for a message of `buffer_size` bytes (plus a 24-byte header), else the
+     * process will be terminated.
+     */
+    size_t spill_segment_size;
+    /**
+     * @brief The path of a write-ahead log file, which makes the channel durable, or `NULL` (the default). In
+     * durable mode, each message is appended to the log, and the log is synced (i.e., `fdatasync`), before the
+     * send function hands the message to the consumer thread, so that a message for which the send function
+     * returned `true` survives a crash. Producers sending at the same time share a single sync (i.e., group
+     * commit). Messages are assigned increasing sequence numbers, and are delivered in that order; the consumer
+     * reports its progress using \ref mpsc_consumer_ack , and the messages that were not acknowledged when the
+     * channel was last used are delivered again (before any new message) by the next channel created with the
+     * same log, which makes delivery at-least-once.
+     * @note - The log is compacted when the channel is created, and truncated whenever all the messages
+     * it holds have been acknowledged once it has grown past `MPSC_WAL_TRUNCATE_SIZE` bytes (1 MiB by default,
+     * which can be changed by defining it when building the library).
+     * @note - I/O errors on the log terminate the process, since durability can't be guaranteed past them.
+     * @note - When set, `pull_mode_enabled`, `executor`, `n_dispatch_workers`, `reusable`, `numa_enabled`,
+     * `realtime_enabled`, `process_shared` and `spill_directory` must be left to their default values, else
+     * the process will be terminated. Such a channel can't be used with \ref mpsc_send_any , or as the upstream
+     * end of \ref mpsc_connect .
+     */
+    const char *wal_path;
+    /**
+     * @brief Whether the durations reported by \ref mpsc_stats (i.e., `wait_time_ns` and `consumer_busy_time_ns`)
+     * are measured, which costs two clock reads per delivered message, and two per send that has to wait.
+     * Defaults to `false`, in which case these durations stay at 0 (unless `latency_histograms_enabled = true`).
+     */
+    bool stats_timing_enabled;
+    /**
+     * @brief Whether latency histograms (see \ref mpsc_latency_histograms ) are recorded, which costs a couple
+     * of clock reads per message. Defaults to `false`.
+     * @note - When set, `process_shared` must be left to its default value, else the process will be terminated.
+     */
+    bool latency_histograms_enabled;
+    /**
+     * @brief The attributes (see \ref mpsc_thread_attributes_t ) of the producer threads created by
+     * \ref mpsc_register_producer .
+     * @note - Threads with non-default attributes are always created for the occasion, rather than
+     * taken from the thread cache (see \ref mpsc_thread_cache_configure ).
+     */
+    mpsc_thread_attributes_t producer_thread_attributes;
 } mpsc_create_params_t;
 
 /**
@@ -224,22 +617,191 @@ typedef struct
  * that not all errors can be handled by the application: some errors will always, regardless of `error_handling_enabled`'s value,
  * result in the process being terminated. Currently, the only errors that can be handled by the application are
  * those related to resources exhaustion (i.e., \ref ENOMEM or \ref EAGAIN ), which, internally, can occur when calling
- * \ref malloc , \ref pthread_mutex_init , \ref pthread_cond_init , or \ref pthread_create .
+ * \ref malloc , \ref pthread_mutex_init , \ref pthread_cond_init , or \ref pthread_create , as well as
+ * insufficient privileges (i.e., \ref EPERM ) when `realtime_enabled = true`.
  */
 mpsc_t *mpsc_create(mpsc_create_params_t params);
 
+/**
+ * @brief An upper bound on the size of a \ref mpsc_t object, used by \ref MPSC_STORAGE_SIZE .
+ */
+#define MPSC_STORAGE_HEADER_SIZE ((size_t)2048)
+
+/**
+ * @brief An upper bound on the size of the state kept for each producer, used by \ref MPSC_STORAGE_SIZE .
+ */
+#define MPSC_STORAGE_PRODUCER_SIZE ((size_t)256)
+
+/**
+ * @brief The number of bytes of storage required by \ref mpsc_init for a channel whose
+ * \ref mpsc_create_params_t has the given `buffer_size` and `n_max_producers`.
+ */
+#define MPSC_STORAGE_SIZE(buffer_size, n_max_producers) \
+    (MPSC_STORAGE_HEADER_SIZE + (size_t)(n_max_producers) * MPSC_STORAGE_PRODUCER_SIZE + (size_t)(buffer_size))
+
+/**
+ * @brief The function used to create a new channel instance (i.e., a \ref mpsc_t instance) inside
+ * of application provided memory (e.g., static storage, the stack or an arena), instead of allocating
+ * it from the heap like \ref mpsc_create does.
+ * @param storage A pointer to the memory in which the instance should be created, which must be
+ * suitably aligned for any type (i.e., `_Alignof(max_align_t)`), else the process will be terminated.
+ * @param storage_size The size of \p storage , which must be at least
+ * `MPSC_STORAGE_SIZE(params.buffer_size, params.n_max_producers)`, else the process will be terminated.
+ * @param params The instance's configurations (see \ref mpsc_create_params_t ).
+ * @return \ref mpsc_t* A pointer to the created \ref mpsc_t object (which points inside of \p storage ), or
+ * \ref NULL if an error occurred (see \ref mpsc_create ).
+ * @note - Neither this call nor the registration of producers allocate memory from the heap (although
+ * the consumer thread still allocates a copy of each message for the consumer callback). Dispatch workers
+ * (i.e., `n_dispatch_workers > 0`) are the exception, since they are always allocated from the heap.
+ * @note - \p storage must remain valid until \ref mpsc_join returns, after which it can be reused.
+ */
+mpsc_t *mpsc_init(void *storage, size_t storage_size, mpsc_create_params_t params);
+
+/**
+ * @brief The function used to create a new \ref mpsc_executor_t instance, to which channels
+ * can then be bound using \ref mpsc_create_params_t 's `executor`.
+ * @param params The instance's configurations (see \ref mpsc_executor_create_params_t ).
+ * @return \ref mpsc_executor_t* A pointer to the created object, or \ref NULL if an error occurred
+ * while `error_handling_enabled = true`, in which case \ref errno will be set to \ref ENOMEM or \ref EAGAIN .
+ */
+mpsc_executor_t *mpsc_executor_create(mpsc_executor_create_params_t params);
+
+/**
+ * @brief The function used to stop the threads of \p self and free its resources.
+ * @param self A pointer to the \ref mpsc_executor_t instance to be destroyed.
+ * @warning All of the channels bound to \p self must have been joined before calling this
+ * function, else the process will be terminated.
+ */
+void mpsc_executor_destroy(mpsc_executor_t *self);
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_thread_cache_configure to configure the
+ * process-wide cache of parked threads used to run the internal consumer and producer threads.
+ * @see mpsc_thread_cache_configure
+ */
+typedef struct
+{
+    /**
+     * @brief The maximum number of threads that can be parked in the cache, waiting to be reused.
+     * @note - When 0 (the default), the cache is disabled and a new thread is created for each
+     * consumer and producer, as with previous versions of this library.
+     */
+    size_t max_idle_threads;
+    /**
+     * @brief The number of milliseconds after which a parked thread that hasn't been reused exits.
+     * @note - When 0, parked threads wait indefinitely.
+     */
+    long idle_timeout_ms;
+} mpsc_thread_cache_params_t;
+
+/**
+ * @brief The function used to enable, configure or disable the process-wide cache of parked threads.
+ * When enabled, a consumer or producer thread whose work is done parks in the cache instead of exiting,
+ * so that the next \ref mpsc_create or \ref mpsc_register_producer call can wake it up rather than
+ * creating a new thread.
+ * @param params The cache's configurations (see \ref mpsc_thread_cache_params_t ).
+ * @note - This function can be called at any time, from any thread. When `max_idle_threads` is
+ * lowered, the extra parked threads exit.
+ * @note - Dispatch workers and executor threads are long-lived, and therefore never use the cache.
+ * @note - Threads that exit the cache are joined by the next call to this function (or to
+ * \ref mpsc_thread_cache_drain ), or by the next thread creation, so they may outlive this call.
+ */
+void mpsc_thread_cache_configure(mpsc_thread_cache_params_t params);
+
+/**
+ * @brief The function used to disable the process-wide thread cache (i.e., like setting `max_idle_threads`
+ * to 0 using \ref mpsc_thread_cache_configure ), and to wait for every cached thread to exit, e.g., before
+ * the library is unloaded or the process shuts down.
+ * @note - Cached threads that are running a consumer or producer callback exit once that callback returns,
+ * so this function must not be called from such a callback, and it waits for the channels still using them.
+ */
+void mpsc_thread_cache_drain(void);
+
 /**
  * @brief The function that must be called on \p self to wait for the channel close.
  * @note - Internally, this function will join the internal consumer thread. Once joined,
  * it will set the internal channel state to closed, and then will join all registered
  * producer threads. Once all internal threads have been joined, \p self 's internal
  * resources will be destroyed and the memory freed.
+ * @note - For channels created with `reusable = true`, this function instead returns once the
+ * consumer callback has been called with `closed = true` and the producer threads have been joined,
+ * leaving \p self to be either reused (see \ref mpsc_reset ) or destroyed (see \ref mpsc_destroy ).
  * @note - In most applications, this function should be called on the same thread as
  * the thread that was used to instantiate \p self (i.e., the \ref mpsc_t object).
  * @param self A pointer to the \ref mpsc_t instance to be joined.
  */
 void mpsc_join(mpsc_t *self);
 
+/**
+ * @brief The function used to return a joined, reusable channel (see \ref mpsc_create_params_t 's
+ * `reusable`) to an open state, so that producers can be registered again.
+ * @param self A pointer to the \ref mpsc_t instance to be reset, which must have been created with
+ * `reusable = true` and joined (see \ref mpsc_join ), and whose producers must all be done (i.e., attached
+ * producers must have been detached using \ref mpsc_producer_detach ), else the process will be terminated.
+ * @note - The channel keeps its buffer, mutex, condition variables, producer slots and internal
+ * consumer thread, so this is much cheaper than destroying and re-creating a channel.
+ */
+void mpsc_reset(mpsc_t *self);
+
+/**
+ * @brief The function used to destroy a joined, reusable channel (see \ref mpsc_create_params_t 's
+ * `reusable`), which stops its internal consumer thread and frees its resources.
+ * @param self A pointer to the \ref mpsc_t instance to be destroyed, which must have been created with
+ * `reusable = true` and joined (see \ref mpsc_join ), and whose producers must all be done (i.e., attached
+ * producers must have been detached using \ref mpsc_producer_detach ), else the process will be terminated.
+ */
+void mpsc_destroy(mpsc_t *self);
+
+/**
+ * @brief The function used to indicate that no more producers will be registered on \p self , other
+ * than from inside producer threads, so that the channel gets closed as soon as all of its producers
+ * are done.
+ * @param self A pointer to the \ref mpsc_t instance to be sealed.
+ * @note - \ref mpsc_join implicitly seals the channel, so calling this function is only useful to
+ * let a channel close before \ref mpsc_join is called; for instance, with `pull_mode_enabled = true`,
+ * so that the receiving thread can get \ref MPSC_RECEIVE_STATUS_CLOSED before joining the channel.
+ * @note - Calling this function more than once has no effect.
+ */
+void mpsc_seal(mpsc_t *self);
+
+/**
+ * @brief The function used to receive the next message from \p self , which must have been created
+ * with `pull_mode_enabled = true`.
+ * @param self A pointer to the \ref mpsc_t instance from which to receive a message.
+ * @param timeout_ms The maximum amount of time to wait for a message, in milliseconds. A negative value
+ * means "wait forever", while 0 means that the function returns immediately.
+ * @param data Set to a pointer to dynamically allocated memory containing the message (or to \ref NULL
+ * for an empty message), which must be freed by the application (see \ref mpsc_consumer_callback_t ).
+ * @param n Set to the message size, in bytes.
+ * @return \ref mpsc_receive_status_t A value indicating whether a message was received.
+ * @see mpsc_select
+ */
+mpsc_receive_status_t mpsc_receive(mpsc_t *self, long timeout_ms, void **data, size_t *n);
+
+/**
+ * @brief The function used to wait for a message on several channels at the same time, and to receive
+ * it from whichever channel has one.
+ * @param channels An array of \p count pointers to \ref mpsc_t instances, each created with
+ * `pull_mode_enabled = true`.
+ * @param count The number of elements in \p channels .
+ * @param timeout_ms The maximum amount of time to wait for a message, in milliseconds. A negative value
+ * means "wait forever", while 0 means that the function returns immediately.
+ * @param index Set to the index, in \p channels , of the channel the returned status is about
+ * (unless \ref MPSC_RECEIVE_STATUS_TIMEOUT is returned).
+ * @param data Set to a pointer to dynamically allocated memory containing the message (or to \ref NULL
+ * for an empty message), which must be freed by the application.
+ * @param n Set to the message size, in bytes.
+ * @return \ref mpsc_receive_status_t A value indicating whether a message was received.
+ * @note - The channels are checked in order, so that earlier channels have priority (e.g., a control
+ * channel can be placed before a bulk data channel).
+ * @note - \ref MPSC_RECEIVE_STATUS_CLOSED is returned, along with the channel's \p index , for each call
+ * as long as a closed channel is part of \p channels , so the application should remove it from the array.
+ * @note - When no channel has a message, the calling thread parks once on all of the channels, rather than
+ * polling them, and is woken up by the first producer to send a message (or by a channel being closed).
+ * @warning A given channel must not be received from by more than one thread at the same time.
+ */
+mpsc_receive_status_t mpsc_select(mpsc_t *channels[], size_t count, long timeout_ms, size_t *index, void **data, size_t *n);
+
 /**
  * @brief The function used to register a new producer for \p self .
  * @param self A pointer to the \ref mpsc_t instance for which to register a new producer.
@@ -254,6 +816,78 @@ void mpsc_join(mpsc_t *self);
  */
 mpsc_register_producer_error_t mpsc_register_producer(mpsc_t *self, mpsc_producer_thread_callback_t callback, void *context);
 
+/**
+ * @brief The function used to attach a threadless producer to \p self ; i.e., a producer that
+ * is not backed by an internal thread, and which can therefore be used from any application thread.
+ * @param self A pointer to the \ref mpsc_t instance to which the producer should be attached.
+ * @param producer Set to a pointer to the attached \ref mpsc_producer_t instance on success.
+ * @return \ref mpsc_register_producer_error_t A value used to report a potential error with the call
+ * (see \ref mpsc_register_producer ). \ref MPSC_REGISTER_PRODUCER_ERROR_EAGAIN is never returned, since
+ * no thread is created.
+ * @note - The attached producer counts towards `n_max_producers`, and it must be detached using
+ * \ref mpsc_producer_detach once it's no longer needed, else the call to \ref mpsc_join will hang.
+ * @note - This is, for instance, what allows a single application thread to hold producers for several
+ * channels and to use \ref mpsc_send_any .
+ * @see mpsc_producer_detach, mpsc_send_any
+ */
+mpsc_register_producer_error_t mpsc_attach_producer(mpsc_t *self, mpsc_producer_t **producer);
+
+/**
+ * @brief The function used to detach a producer that was attached using \ref mpsc_attach_producer ,
+ * which has the same effect as a registered producer's thread callback function returning.
+ * @param self A pointer to the \ref mpsc_producer_t instance to be detached, which must not be used afterwards.
+ * @note - The producer's slot is recycled, so the same pointer might be handed over by a later call
+ * to \ref mpsc_attach_producer .
+ * @see mpsc_attach_producer
+ */
+void mpsc_producer_detach(mpsc_producer_t *self);
+
+/**
+ * @brief The function used to attach a threadless producer to a process-shared channel (see
+ * \ref mpsc_create_params_t 's `process_shared`), which can be called from a child process, and
+ * otherwise behaves like \ref mpsc_attach_producer .
+ * @param self A pointer to the process-shared \ref mpsc_t instance to which the producer should be attached,
+ * as inherited from the creating process. The process will be terminated if the channel isn't process-shared.
+ * @param producer Set to a pointer to the attached \ref mpsc_producer_t instance on success.
+ * @return \ref mpsc_register_producer_error_t A value used to report a potential error with the call
+ * (see \ref mpsc_attach_producer ).
+ * @note - The producer must be detached using \ref mpsc_producer_detach before the child process exits,
+ * else the call to \ref mpsc_join (in the creating process) will hang.
+ * @note - Since \ref mpsc_join seals the channel, child processes should attach their producers before
+ * the creating process joins the channel (e.g., by having the creating process wait for them to do so).
+ * @see mpsc_attach_producer, mpsc_producer_detach
+ */
+mpsc_register_producer_error_t mpsc_shm_attach_producer(mpsc_t *self, mpsc_producer_t **producer);
+
+/**
+ * @brief The function used to register a file descriptor (e.g., a pipe or a socket) as a source of messages
+ * for \p self , which replaces a producer thread blocking on that file descriptor. All of a channel's file
+ * descriptor sources are read by a single internal thread (i.e., using `epoll`), which splits the bytes into
+ * messages using \p framing , and sends them to the channel.
+ * @param self A pointer to the \ref mpsc_t instance for which \p fd should be registered.
+ * @param fd The file descriptor to be read from, which is switched to non-blocking mode, and which the channel
+ * takes ownership of (i.e., it's closed once it reaches end-of-file or fails, or once the channel has been closed).
+ * When the registration fails, \p fd is left untouched (i.e., its flags are restored), and still owned by the caller.
+ * The process will be terminated if \p fd isn't an open file descriptor.
+ * @param framing An optional (i.e., can be \ref NULL ) function used to split the bytes into messages (see
+ * \ref mpsc_framing_callback_t ). When \ref NULL , each read (of up to `buffer_size` bytes) is a message.
+ * @param context An optional application defined context passed to \p framing .
+ * @return \ref mpsc_register_producer_error_t A value used to report a potential error with the call
+ * (see \ref mpsc_register_producer ), including \ref MPSC_REGISTER_PRODUCER_ERROR_EMFILE when the file
+ * descriptors needed to poll the sources can't be created, and \ref MPSC_REGISTER_PRODUCER_ERROR_INVALID_FD when
+ * \p fd can't be polled.
+ * @note - The internal thread is started, and attached as one of \p self 's producers, by the first call for
+ * a given channel. It's detached once the channel has been sealed (e.g., by \ref mpsc_join ) and all sources have
+ * reached end-of-file, so \ref mpsc_join only returns after that.
+ * @note - When the channel is full, the internal thread waits for it to accept the next message, and stops reading
+ * in the meantime, so that backpressure reaches the writers through the file descriptors' buffers.
+ * @note - A source whose pending bytes fill its read buffer (i.e., `buffer_size` plus `MPSC_FD_SOURCE_READ_SIZE`
+ * bytes) without completing a message is closed.
+ * @note - \p self must not be reusable (see \ref mpsc_create_params_t ), else the process will be terminated.
+ * @note - File descriptor sources are only supported on Linux; elsewhere, the process is terminated.
+ */
+mpsc_register_producer_error_t mpsc_register_fd_source(mpsc_t *self, int fd, mpsc_framing_callback_t *framing, void *context);
+
 /**
  * @brief An alias for \ref mpsc_register_producer , but which is used on an object of
  * type \ref mpsc_consumer_t , to try to register a producer for \p self 's parent channel object.
@@ -285,6 +919,192 @@ mpsc_register_producer_error_t mpsc_consumer_register_producer(mpsc_consumer_t *
  */
 void mpsc_consumer_close(mpsc_consumer_t *self);
 
+/**
+ * @brief A function that can be used from inside the application defined consumer callback to retrieve
+ * the sequence number of the message being delivered, for a durable channel (see \ref mpsc_create_params_t 's
+ * `wal_path`).
+ * @param self A pointer to the \ref mpsc_consumer_t instance passed to the consumer callback.
+ * @return \ref uint64_t The message's sequence number, which is greater than 0.
+ * @note - The process will be terminated if \p self 's channel isn't durable.
+ */
+uint64_t mpsc_consumer_sequence(mpsc_consumer_t *self);
+
+/**
+ * @brief A function that can be used, for a durable channel (see \ref mpsc_create_params_t 's `wal_path`),
+ * to acknowledge that the message whose sequence number (see \ref mpsc_consumer_sequence ) is \p sequence,
+ * as well as all the messages delivered before it, have been processed, so that they're not delivered again
+ * by the next channel created with the same log.
+ * @param self A pointer to the \ref mpsc_consumer_t instance passed to the consumer callback.
+ * @param sequence The sequence number up to which messages are acknowledged. Acknowledging a sequence
+ * number that was already acknowledged has no effect.
+ * @note - Acknowledgements are appended to the log without syncing it, so a crash can cause
+ * a few acknowledged messages to be delivered again. The exception is an acknowledgement that
+ * covers every message in the log once it has grown past `MPSC_WAL_TRUNCATE_SIZE` bytes (see
+ * \ref mpsc_create_params_t 's `wal_path`), which truncates it, and syncs it before returning. That
+ * sync is done without holding the channel's lock (i.e., producers aren't stalled by it), and happens at
+ * most once per `MPSC_WAL_TRUNCATE_SIZE` bytes logged.
+ * @note - This function can be called from any thread. The process will be terminated if \p self 's channel
+ * isn't durable, or if \p sequence was never assigned to a message.
+ */
+void mpsc_consumer_ack(mpsc_consumer_t *self, uint64_t sequence);
+
+/**
+ * @brief The structure filled by \ref mpsc_stats , with counters that cover the channel's whole
+ * lifetime (i.e., they're not reset by \ref mpsc_reset ).
+ * @see mpsc_stats
+ */
+typedef struct
+{
+    /**
+     * @brief The number of messages (and their total size, in bytes) sent by the channel's producers.
+     */
+    uint64_t n_messages_sent;
+    uint64_t n_bytes_sent;
+    /**
+     * @brief The number of messages (and their total size, in bytes) handed to the consumer callback,
+     * or returned by \ref mpsc_receive and \ref mpsc_select in pull mode.
+     */
+    uint64_t n_messages_delivered;
+    uint64_t n_bytes_delivered;
+    /**
+     * @brief The number of sends that had to wait in the producers' wait queue (i.e., because the internal
+     * buffer was busy), and the total time spent waiting there, in nanoseconds.
+     * @note - `wait_time_ns` is only measured when `stats_timing_enabled = true` (see \ref mpsc_create_params_t ).
+     */
+    uint64_t n_sends_waited;
+    uint64_t wait_time_ns;
+    /**
+     * @brief The number of messages waiting to be delivered: the one in the internal buffer, plus one for
+     * each producer in the wait queue, plus the spilled ones (see \ref mpsc_create_params_t 's
+     * `spill_directory`). NUMA sub-queues (see `numa_enabled`) aren't included.
+     */
+    size_t queue_depth;
+    /**
+     * @brief The highest value reached by `queue_depth`.
+     */
+    size_t max_queue_depth;
+    /**
+     * @brief The total time spent inside of the consumer callback (excluding the calls with `closed = true`),
+     * in nanoseconds, summed over the dispatch workers (see `n_dispatch_workers`), if any.
+     * @note - Only measured when `stats_timing_enabled = true` (see \ref mpsc_create_params_t ).
+     */
+    uint64_t consumer_busy_time_ns;
+    /**
+     * @brief The number of times the consumer thread woke up (or, when busy polling, stopped polling) while
+     * waiting for a message, and the number of times producers woke up while waiting in the wait queue.
+     */
+    uint64_t n_consumer_wakeups;
+    uint64_t n_producer_wakeups;
+} mpsc_stats_t;
+
+/**
+ * @brief A function that can be used to retrieve \p self 's statistics, e.g., to size `buffer_size` and
+ * the various capacities, or to spot backpressure (i.e., a growing `n_sends_waited` or `wait_time_ns`).
+ * @param self A pointer to the \ref mpsc_t instance whose statistics should be retrieved.
+ * @param out A pointer to the \ref mpsc_stats_t object to fill.
+ * @note - Each thread updates its own counters (e.g., each producer has its own), without any
+ * synchronization beyond relaxed atomics, and this function sums them, so the counters it returns
+ * are consistent with each other only up to the sends and deliveries that are in progress.
+ * @note - This function can be called from any thread, while the channel hasn't been destroyed.
+ */
+void mpsc_stats(mpsc_t *self, mpsc_stats_t *out);
+
+/**
+ * @brief The number of sub-buckets per power of two in a \ref mpsc_histogram_t , as a power of two (i.e.,
+ * 16 sub-buckets, which bounds the relative error of the recorded values to 1/16).
+ */
+#define MPSC_HISTOGRAM_SUB_BUCKET_BITS (4)
+
+/**
+ * @brief The exponent of the largest power of two tracked by a \ref mpsc_histogram_t , in nanoseconds
+ * (i.e., about 18 minutes). Larger values are recorded in the last bucket.
+ */
+#define MPSC_HISTOGRAM_MAX_EXPONENT (39)
+
+/**
+ * @brief The number of buckets in a \ref mpsc_histogram_t : one per value below
+ * `2^MPSC_HISTOGRAM_SUB_BUCKET_BITS`, and then `2^MPSC_HISTOGRAM_SUB_BUCKET_BITS` per power of two.
+ */
+#define MPSC_HISTOGRAM_N_BUCKETS ((size_t)(MPSC_HISTOGRAM_MAX_EXPONENT - MPSC_HISTOGRAM_SUB_BUCKET_BITS + 2) << MPSC_HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * @brief A log-bucketed histogram of durations, in nanoseconds.
+ * @see mpsc_latency_histograms
+ * @see mpsc_histogram_percentile
+ * @see mpsc_histogram_bucket_upper_bound
+ */
+typedef struct
+{
+    /**
+     * @brief The number of recorded values (i.e., the sum of `counts`).
+     */
+    uint64_t n_samples;
+    /**
+     * @brief The smallest, largest and total recorded values, which are exact (i.e., not bucketed).
+     * `min_ns` and `max_ns` are 0 when `n_samples = 0`.
+     */
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t total_ns;
+    /**
+     * @brief The number of values recorded in each bucket, the i-th bucket holding the values from
+     * `mpsc_histogram_bucket_upper_bound(i - 1) + 1` to `mpsc_histogram_bucket_upper_bound(i)`.
+     */
+    uint64_t counts[MPSC_HISTOGRAM_N_BUCKETS];
+} mpsc_histogram_t;
+
+/**
+ * @brief The structure filled by \ref mpsc_latency_histograms .
+ */
+typedef struct
+{
+    /**
+     * @brief The duration of the send function calls (i.e., \ref mpsc_producer_send and its variants),
+     * including the time spent waiting in the producers' wait queue, for the messages that were sent.
+     */
+    mpsc_histogram_t send;
+    /**
+     * @brief The time from when a message was handed to the channel (i.e., copied into its internal buffer, or
+     * spilled) until the consumer callback was called with it (or, in pull mode, until it was received). Not
+     * recorded in NUMA mode, nor for the messages replayed from a write-ahead log.
+     */
+    mpsc_histogram_t delivery;
+    /**
+     * @brief The duration of the consumer callback calls (excluding the calls with `closed = true`).
+     */
+    mpsc_histogram_t callback;
+} mpsc_latency_histograms_t;
+
+/**
+ * @brief A function that can be used to retrieve \p self 's latency histograms, e.g., to look at the tail
+ * latencies (see \ref mpsc_histogram_percentile ) when tuning `busy_poll_idle_timeout_us` or the capacities.
+ * @param self A pointer to the \ref mpsc_t instance whose histograms should be retrieved. It must have been
+ * created with `latency_histograms_enabled = true`, else the process will be terminated.
+ * @param out A pointer to the \ref mpsc_latency_histograms_t object to fill (which, at about 14 KiB, is
+ * better not allocated on a small stack).
+ * @note - Each thread records into its own histograms (e.g., each producer has its own), without any
+ * synchronization beyond relaxed atomics, and this function merges them.
+ * @note - This function can be called from any thread, while the channel hasn't been destroyed.
+ */
+void mpsc_latency_histograms(mpsc_t *self, mpsc_latency_histograms_t *out);
+
+/**
+ * @brief A function that can be used to estimate the value below which \p percentile percent of the values
+ * recorded in \p self fall (e.g., 99.9 for the p999).
+ * @param self A pointer to the \ref mpsc_histogram_t to look at.
+ * @param percentile A value between 0 and 100, else the process will be terminated.
+ * @return uint64_t The upper bound of the bucket that holds the value of that rank (capped to `max_ns`),
+ * or 0 when `n_samples = 0`.
+ */
+uint64_t mpsc_histogram_percentile(const mpsc_histogram_t *self, double percentile);
+
+/**
+ * @brief A function that returns the largest value recorded in the bucket at \p index .
+ * @param index A value smaller than \ref MPSC_HISTOGRAM_N_BUCKETS , else the process will be terminated.
+ * @return uint64_t The bucket's (inclusive) upper bound, in nanoseconds.
+ */
+uint64_t mpsc_histogram_bucket_upper_bound(size_t index);
+
 /**
  * @brief A function that can be used from inside a producer thread callback to check whether
  * the channel to which \p self belongs is still opened.
@@ -327,6 +1147,44 @@ bool mpsc_producer_ping(mpsc_producer_t *self);
  */
 bool mpsc_producer_send(mpsc_producer_t *self, void *data, size_t n);
 
+/**
+ * @brief Similar to \ref mpsc_producer_send , except that the message carries an application
+ * defined key hash, which is used to route the message to a dispatch worker when
+ * \ref mpsc_create_params_t 's `n_dispatch_workers` is non-zero.
+ * @param self A pointer to the \ref mpsc_producer_t instance for which to send a message
+ * down the underlying channel, to be delivered to the consumer.
+ * @param key_hash An application defined hash of the message's ordering key (e.g., a
+ * session or an account identifier). Messages sharing the same key hash are always delivered
+ * by the same dispatch worker, in order.
+ * @param data A pointer to arbitrary bytes ( \p n  bytes) to be sent to the channel's consumer.
+ * @param n the message size, in bytes.
+ * @return \ref bool A boolean value indicating whether the message was accepted or not (see
+ * \ref mpsc_producer_send for details).
+ * @note When `n_dispatch_workers = 0`, \p key_hash is ignored and this function behaves exactly
+ * like \ref mpsc_producer_send .
+ * @see mpsc_producer_send, mpsc_create_params_t
+ */
+bool mpsc_producer_send_keyed(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n);
+
+/**
+ * @brief The function used to send a message to the first of several channels that can accept it
+ * without blocking, in the same way as a Go `select` statement over several sends.
+ * @param producers An array of \p count pointers to \ref mpsc_producer_t instances (typically attached
+ * using \ref mpsc_attach_producer ), each belonging to the channel to which the message may be sent.
+ * @param count The number of elements in \p producers .
+ * @param data A pointer to arbitrary bytes ( \p n  bytes) to be sent.
+ * @param n The message size, in bytes, which must not be greater than the `buffer_size` of any of the channels.
+ * @return \ref ssize_t The index, in \p producers , of the producer whose channel accepted the message, or
+ * -1 if all of the channels have been closed.
+ * @note - The channels are tried in order, so that earlier producers are preferred. If none of the channels can
+ * accept the message immediately, the calling thread parks (once) on all of them, and is woken up as soon as
+ * any of them has room for a message (or is closed).
+ * @note - Producers blocked inside \ref mpsc_producer_send on a given channel have priority over
+ * this function for that channel.
+ * @see mpsc_attach_producer, mpsc_producer_send
+ */
+ssize_t mpsc_send_any(mpsc_producer_t *producers[], size_t count, void *data, size_t n);
+
 /**
  * @brief Similar to \ref mpsc_producer_send , except that this function is used (from
  * inside a producer thread callback function) to send an empty message.
@@ -374,4 +1232,385 @@ void *mpsc_producer_context(mpsc_producer_t *self);
  */
 mpsc_register_producer_error_t mpsc_producer_register_producer(mpsc_producer_t *self, mpsc_producer_thread_callback_t callback, void *context);
 
+/**
+ * @brief The function used to chain \p upstream to \p downstream , so that the messages received
+ * by \p upstream are moved (and optionally transformed) directly from its internal buffer into
+ * \p downstream 's internal buffer, on \p upstream 's internal consumer thread.
+ * @param upstream A pointer to the \ref mpsc_t instance whose messages should be forwarded.
+ * @param downstream A pointer to the \ref mpsc_t instance to which the messages should be forwarded.
+ * @param transform An optional (i.e., can be \ref NULL ) application defined callback used to
+ * transform (or drop) each message in place before it is forwarded.
+ * @param context An application defined context object passed to \p transform .
+ * @return \ref mpsc_register_producer_error_t The result of registering \p upstream as a producer of
+ * \p downstream (see \ref mpsc_register_producer_error_t ), which means that the connection counts towards
+ * \p downstream 's `n_max_producers`. A successful call will return \ref MPSC_REGISTER_PRODUCER_ERROR_NONE .
+ * @note - Once connected, \p upstream 's consumer callback is no longer called for messages (it
+ * only receives the final call with `closed = true`). Forwarding a message requires neither a call to
+ * \ref malloc nor a thread handoff, and the message stays in \p upstream 's internal buffer until
+ * \p downstream has accepted it, so that \p downstream 's backpressure is propagated to \p upstream 's
+ * producers.
+ * @note - \p upstream counts as a producer of \p downstream until \p upstream is closed, so the stages
+ * of a pipeline should be joined in order (i.e., \p upstream first). If \p downstream gets closed,
+ * \p upstream is closed as well.
+ * @note - \p upstream must not already be connected, must not use dispatch workers (i.e.,
+ * `n_dispatch_workers = 0`), must not use pull mode and must not be bound to an executor, else
+ * the process will be terminated.
+ */
+mpsc_register_producer_error_t mpsc_connect(mpsc_t *upstream, mpsc_t *downstream, mpsc_transform_callback_t *transform, void *context);
+
+/**
+ * @brief An opaque data type used as a container for a broadcast channel, which is the
+ * reverse topology of a \ref mpsc_t instance: a single producer (e.g., a control thread)
+ * sends messages that are read by every subscriber.
+ * @see mpsc_broadcast_create, mpsc_broadcast_destroy
+ */
+typedef struct mpsc_broadcast_s mpsc_broadcast_t;
+
+/**
+ * @brief An opaque data type used as a container for a \ref mpsc_broadcast_t subscriber,
+ * which holds the subscriber's read cursor inside the broadcast channel's shared ring.
+ * @see mpsc_broadcast_subscribe, mpsc_broadcast_unsubscribe
+ */
+typedef struct mpsc_broadcast_subscriber_s mpsc_broadcast_subscriber_t;
+
+/**
+ * @brief The type returned by \ref mpsc_broadcast_receive and \ref mpsc_broadcast_try_receive ,
+ * which indicates whether a message was received.
+ */
+typedef enum
+{
+    /**
+     * @brief A message was received and must be released using \ref mpsc_broadcast_release
+     * once it is no longer needed.
+     */
+    MPSC_BROADCAST_RECEIVE_STATUS_MESSAGE = 0,
+    /**
+     * @brief No message is currently available for the subscriber (only returned by
+     * \ref mpsc_broadcast_try_receive ).
+     */
+    MPSC_BROADCAST_RECEIVE_STATUS_EMPTY = 1,
+    /**
+     * @brief The broadcast channel has been closed using \ref mpsc_broadcast_close and the
+     * subscriber has read all of the messages that were sent before that.
+     */
+    MPSC_BROADCAST_RECEIVE_STATUS_CLOSED = 2
+} mpsc_broadcast_receive_status_t;
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_broadcast_create to instantiate
+ * a new \ref mpsc_broadcast_t object.
+ * @see mpsc_broadcast_create
+ */
+typedef struct
+{
+    /**
+     * @brief The size (in bytes) of each slot of the shared ring, which acts as the upper
+     * bound of a message size (see \ref mpsc_create_params_t 's `buffer_size`).
+     */
+    size_t buffer_size;
+    /**
+     * @brief The number of slots in the shared ring; i.e., the number of messages the
+     * producer can be ahead of the slowest subscriber before \ref mpsc_broadcast_send blocks.
+     * @note This value must be greater than 0, else the process will be terminated.
+     */
+    size_t capacity;
+    /**
+     * @brief The maximum number of subscribers that can be subscribed at the same time.
+     * @note This value must be greater than 0, else the process will be terminated.
+     */
+    size_t n_max_subscribers;
+    /**
+     * @brief A boolean value indicating whether resources exhaustion errors in
+     * \ref mpsc_broadcast_create should be handed over to the application (i.e., \ref NULL
+     * is returned and \ref errno is set) or whether the process should be terminated.
+     */
+    bool error_handling_enabled;
+    /**
+     * @brief A boolean value indicating whether the shared ring should be backed by huge pages (see
+     * \ref mpsc_create_params_t 's `huge_pages_enabled`).
+     */
+    bool huge_pages_enabled;
+} mpsc_broadcast_create_params_t;
+
+/**
+ * @brief The function used to create a new broadcast channel instance.
+ * @param params The instance's configurations (see \ref mpsc_broadcast_create_params_t ).
+ * @return \ref mpsc_broadcast_t* A pointer to the created object, or \ref NULL if an error occurred
+ * while `error_handling_enabled = true`, in which case \ref errno will be set to \ref ENOMEM or \ref EAGAIN .
+ * @note Unlike \ref mpsc_create , this function does not create any thread: the producer and the
+ * subscribers are application threads (e.g., a control thread and a channel's producer threads).
+ */
+mpsc_broadcast_t *mpsc_broadcast_create(mpsc_broadcast_create_params_t params);
+
+/**
+ * @brief The function used to destroy \p self and free its resources.
+ * @param self A pointer to the \ref mpsc_broadcast_t instance to be destroyed.
+ * @warning All subscribers must have been unsubscribed (using \ref mpsc_broadcast_unsubscribe ) before
+ * calling this function, else the process will be terminated.
+ */
+void mpsc_broadcast_destroy(mpsc_broadcast_t *self);
+
+/**
+ * @brief The function used to subscribe to \p self .
+ * @param self A pointer to the \ref mpsc_broadcast_t instance to subscribe to.
+ * @return \ref mpsc_broadcast_subscriber_t* A pointer to the new subscriber, or \ref NULL if
+ * `n_max_subscribers` subscribers are already subscribed.
+ * @note A new subscriber only receives the messages sent after it subscribed.
+ */
+mpsc_broadcast_subscriber_t *mpsc_broadcast_subscribe(mpsc_broadcast_t *self);
+
+/**
+ * @brief The function used to unsubscribe \p self from its broadcast channel, after which
+ * the producer no longer waits for \p self to read its messages.
+ * @param self A pointer to the \ref mpsc_broadcast_subscriber_t instance to unsubscribe, which
+ * must not be used afterwards.
+ */
+void mpsc_broadcast_unsubscribe(mpsc_broadcast_subscriber_t *self);
+
+/**
+ * @brief The function used by the (single) producer to send a message to all subscribers.
+ * @param self A pointer to the \ref mpsc_broadcast_t instance.
+ * @param data A pointer to arbitrary bytes ( \p n  bytes) to be sent to the subscribers.
+ * @param n The message size, in bytes, which must not be greater than `buffer_size`, else
+ * the process will be terminated.
+ * @return \ref bool `false` if the broadcast channel has been closed, else `true`.
+ * @note - The message is copied once into the shared ring, and every subscriber reads that
+ * same copy (i.e., there is no per-subscriber copy).
+ * @note - This function blocks while the ring is full; i.e., while the slowest subscriber
+ * is `capacity` messages behind.
+ */
+bool mpsc_broadcast_send(mpsc_broadcast_t *self, void *data, size_t n);
+
+/**
+ * @brief The function used to close \p self . Subscribers can still read the messages that
+ * were sent before closing, after which they receive \ref MPSC_BROADCAST_RECEIVE_STATUS_CLOSED .
+ * @param self A pointer to the \ref mpsc_broadcast_t instance to be closed.
+ */
+void mpsc_broadcast_close(mpsc_broadcast_t *self);
+
+/**
+ * @brief The function used by a subscriber to wait for its next message.
+ * @param self A pointer to the \ref mpsc_broadcast_subscriber_t instance.
+ * @param data Set to a pointer to the message bytes, which point directly into the shared ring
+ * and remain valid until \ref mpsc_broadcast_release is called, or to \ref NULL for an empty message.
+ * @param n Set to the message size, in bytes.
+ * @return \ref mpsc_broadcast_receive_status_t Either \ref MPSC_BROADCAST_RECEIVE_STATUS_MESSAGE or
+ * \ref MPSC_BROADCAST_RECEIVE_STATUS_CLOSED .
+ * @warning The received bytes must not be modified, since they are shared with the other subscribers.
+ * @note Calling this function again without first calling \ref mpsc_broadcast_release returns
+ * the same message.
+ */
+mpsc_broadcast_receive_status_t mpsc_broadcast_receive(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n);
+
+/**
+ * @brief A non-blocking version of \ref mpsc_broadcast_receive , which returns
+ * \ref MPSC_BROADCAST_RECEIVE_STATUS_EMPTY when no message is available. This is meant to be
+ * used, for instance, from inside a producer thread callback, in place of (or along with)
+ * \ref mpsc_producer_ping .
+ * @see mpsc_broadcast_receive
+ */
+mpsc_broadcast_receive_status_t mpsc_broadcast_try_receive(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n);
+
+/**
+ * @brief The function used by a subscriber to release the message most recently returned by
+ * \ref mpsc_broadcast_receive or \ref mpsc_broadcast_try_receive , which advances its read cursor.
+ * @param self A pointer to the \ref mpsc_broadcast_subscriber_t instance.
+ */
+void mpsc_broadcast_release(mpsc_broadcast_subscriber_t *self);
+
+/**
+ * @brief An opaque data type used as a container for a socket bridge, which accepts messages from
+ * producers running in other processes (e.g., sandboxed workers that can't share memory with the
+ * consumer's process) over a local (i.e., `AF_UNIX`) datagram socket, and injects them into a channel
+ * as if they were sent by one of its producers.
+ * @see mpsc_bridge_create, mpsc_bridge_destroy
+ */
+typedef struct mpsc_bridge_s mpsc_bridge_t;
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_bridge_create to instantiate
+ * a new \ref mpsc_bridge_t object.
+ * @see mpsc_bridge_create
+ */
+typedef struct
+{
+    /**
+     * @brief The file system path at which the bridge's socket should be bound, which must not
+     * already exist, and must fit in `sockaddr_un`'s `sun_path`, else the process will be terminated.
+     */
+    const char *path;
+    /**
+     * @brief The maximum number of datagrams read from the socket at once (i.e., using `recvmmsg` on Linux,
+     * else one `recvmsg` call per datagram).
+     * @note This value must be greater than 0, else the process will be terminated.
+     */
+    size_t batch_size;
+    /**
+     * @brief A boolean value indicating whether errors in \ref mpsc_bridge_create should be handed
+     * over to the application (i.e., \ref NULL is returned and \ref errno is set) or whether the
+     * process should be terminated.
+     */
+    bool error_handling_enabled;
+} mpsc_bridge_create_params_t;
+
+/**
+ * @brief The function used to create a new socket bridge for \p mpsc , which attaches a producer to
+ * \p mpsc (see \ref mpsc_attach_producer ), binds a datagram socket at `params.path`, and starts a thread
+ * that forwards each datagram received on the socket to \p mpsc , as a message.
+ * @param mpsc A pointer to the \ref mpsc_t instance into which messages should be injected.
+ * @param params The instance's configurations (see \ref mpsc_bridge_create_params_t ).
+ * @return \ref mpsc_bridge_t* A pointer to the created object, or \ref NULL if an error occurred while
+ * `error_handling_enabled = true`, in which case \ref errno will be set to the error reported by \ref socket
+ * or \ref bind (e.g., \ref EADDRINUSE ), to \ref ENOMEM or \ref EAGAIN , to \ref EBUSY if \p mpsc
+ * already has `n_max_producers` producers, or to \ref EPIPE if \p mpsc has been closed.
+ * @note - Each datagram is one message (i.e., datagram boundaries act as the message framing), so a
+ * producer process simply connects a `SOCK_DGRAM` socket to `params.path` and sends each message using
+ * \ref send . Datagrams larger than \p mpsc 's `buffer_size` are dropped (see
+ * \ref mpsc_bridge_n_dropped_datagrams ). Messages sent by a given process are delivered in order.
+ * @note - An `AF_UNIX` datagram can't be larger than the sending socket's send buffer (i.e., `SO_SNDBUF`,
+ * which defaults to about 208 KiB on Linux), so larger messages fail in the producer process's \ref send
+ * (i.e., with \ref EMSGSIZE ), unless it increases `SO_SNDBUF` first.
+ * @note - When \p mpsc 's producers have to wait, the bridge stops reading from the socket, so its queue
+ * fills up, and producer processes block in \ref send (i.e., backpressure reaches them).
+ * @see mpsc_bridge_destroy
+ */
+mpsc_bridge_t *mpsc_bridge_create(mpsc_t *mpsc, mpsc_bridge_create_params_t params);
+
+/**
+ * @brief The function used to stop and release a socket bridge. The datagrams that are already
+ * queued on the socket are forwarded, after which the bridge's producer is detached (see
+ * \ref mpsc_producer_detach ) and the socket is closed and unlinked.
+ * @param self A pointer to the \ref mpsc_bridge_t instance to be destroyed.
+ * @note - Since the bridge holds a producer, it must be destroyed before \ref mpsc_join can return.
+ */
+void mpsc_bridge_destroy(mpsc_bridge_t *self);
+
+/**
+ * @brief The function used to get the number of datagrams that a socket bridge has dropped so far,
+ * because they were larger than its channel's `buffer_size` (i.e., they were truncated when read).
+ * @param self A pointer to the \ref mpsc_bridge_t instance.
+ * @return uint64_t The number of dropped datagrams.
+ * @note - This function can be called from any thread, while the bridge is running.
+ */
+uint64_t mpsc_bridge_n_dropped_datagrams(const mpsc_bridge_t *self);
+
+/**
+ * @brief An opaque data type used as a container for a trace recorder, which captures the traffic sent
+ * to a channel (i.e., each message's timestamp, producer index, size and, optionally, payload) to a compact
+ * binary trace file, which can later be re-injected into a channel using \ref mpsc_trace_replay .
+ * @see mpsc_trace_start, mpsc_trace_stop
+ */
+typedef struct mpsc_trace_s mpsc_trace_t;
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_trace_start to instantiate
+ * a new \ref mpsc_trace_t object.
+ * @see mpsc_trace_start
+ */
+typedef struct
+{
+    /**
+     * @brief The path of the trace file, which is created, or truncated if it already exists.
+     */
+    const char *path;
+    /**
+     * @brief A boolean value indicating whether the messages' bytes should be recorded,
+     * rather than only their sizes.
+     */
+    bool payloads_enabled;
+    /**
+     * @brief The size, in bytes, of the buffer in which each producer records its messages until the
+     * trace's writer thread flushes it. The value 0 (the default) means `MPSC_TRACE_BUFFER_SIZE` (64 KiB,
+     * unless overridden at compile time).
+     * @note - When `payloads_enabled = true`, the buffer must be able to hold a message of the channel's
+     * `buffer_size` bytes (plus a 24-byte record header), else the process will be terminated.
+     */
+    size_t producer_buffer_size;
+    /**
+     * @brief The interval, in milliseconds, at which the trace's writer thread flushes the producers'
+     * buffers to the file. The value 0 (the default) means `MPSC_TRACE_FLUSH_INTERVAL_MS` (10 ms, unless
+     * overridden at compile time).
+     * @note - Must not be negative, else the process will be terminated.
+     */
+    long flush_interval_ms;
+    /**
+     * @brief A boolean value indicating whether errors in \ref mpsc_trace_start should be handed
+     * over to the application (i.e., \ref NULL is returned and \ref errno is set) or whether the
+     * process should be terminated.
+     */
+    bool error_handling_enabled;
+} mpsc_trace_create_params_t;
+
+/**
+ * @brief The function used to start recording \p mpsc 's traffic. From then on, each successful call to a
+ * send function on one of \p mpsc 's producers appends a record to the producer's trace buffer (without
+ * taking any lock, or making any system call), and a background writer thread periodically appends
+ * the buffers' contents to the trace file.
+ * @param mpsc A pointer to the \ref mpsc_t instance whose traffic should be recorded.
+ * @param params The instance's configurations (see \ref mpsc_trace_create_params_t ).
+ * @return \ref mpsc_trace_t* A pointer to the created object, or \ref NULL if an error occurred while
+ * `error_handling_enabled = true`, in which case \ref errno will be set to the error reported by \ref open
+ * (e.g., \ref ENOENT ), or to \ref ENOMEM or \ref EAGAIN .
+ * @note - Records are timestamped once the message has been sent, and each producer is identified by its
+ * slot index, which a producer registered later can reuse. A record that doesn't fit in its producer's
+ * buffer (i.e., because the writer thread can't keep up) is dropped rather than blocking the producer.
+ * @note - A channel can only be traced by one recorder at a time, and process-shared channels can't be
+ * traced, else the process will be terminated. I/O errors on the trace file terminate the process.
+ * @see mpsc_trace_stop, mpsc_trace_replay
+ */
+mpsc_trace_t *mpsc_trace_start(mpsc_t *mpsc, mpsc_trace_create_params_t params);
+
+/**
+ * @brief The function used to stop recording, which waits for the producers that are recording
+ * a message to be done, flushes the remaining records to the trace file, and releases \p self .
+ * @param self A pointer to the \ref mpsc_trace_t instance to be stopped.
+ * @return \ref uint64_t The number of records that were dropped because they didn't fit in their
+ * producer's buffer.
+ * @note - Must be called before \p self 's channel is destroyed (e.g., before \ref mpsc_join ).
+ */
+uint64_t mpsc_trace_stop(mpsc_trace_t *self);
+
+/**
+ * @brief The structure that must be passed to \ref mpsc_trace_replay .
+ * @see mpsc_trace_replay
+ */
+typedef struct
+{
+    /**
+     * @brief The path of a trace file recorded by \ref mpsc_trace_start .
+     */
+    const char *path;
+    /**
+     * @brief The factor by which the trace's timing should be accelerated (e.g., 2.0 replays it twice
+     * as fast). The value 0 (the default) means that the trace is replayed at its original speed.
+     * @note - Must not be negative, else the process will be terminated.
+     */
+    double speedup;
+    /**
+     * @brief A boolean value indicating whether errors in \ref mpsc_trace_replay should be handed
+     * over to the application (i.e., `false` is returned and \ref errno is set) or whether the
+     * process should be terminated.
+     */
+    bool error_handling_enabled;
+} mpsc_trace_replay_params_t;
+
+/**
+ * @brief The function used to re-inject a recorded trace into \p mpsc , which can be used to drive a
+ * consumer callback with a realistic load (e.g., in benchmarks). One producer is attached to \p mpsc (see
+ * \ref mpsc_attach_producer ) for each producer found in the trace, and sends that producer's messages,
+ * in order, from its own thread, each at its recorded time (relative to the start of the replay), divided
+ * by `params.speedup`. The function returns once every message has been sent and the producers have been
+ * detached.
+ * @param mpsc A pointer to the \ref mpsc_t instance into which the trace should be injected.
+ * @param params The replay's configurations (see \ref mpsc_trace_replay_params_t ).
+ * @return \ref bool `true` on success, or `false` if an error occurred while `error_handling_enabled = true`,
+ * in which case \ref errno will be set to the error reported by \ref open (e.g., \ref ENOENT ), to \ref EINVAL if
+ * the file isn't a trace, to \ref ENOMEM or \ref EAGAIN , to \ref EBUSY if \p mpsc doesn't have enough
+ * free producer slots, or to \ref EPIPE if \p mpsc has been closed.
+ * @note - Messages recorded without their payload are replayed as zero-filled messages of the recorded
+ * size, and messages larger than \p mpsc 's `buffer_size` are truncated to that size. A producer stops
+ * replaying if \p mpsc gets closed, and a record left incomplete at the end of the file is ignored.
+ */
+bool mpsc_trace_replay(mpsc_t *mpsc, mpsc_trace_replay_params_t params);
+
 #endif
@@ -22,11 +22,32 @@
     THE SOFTWARE.
 */
 
+// NOTE: The CPU affinity and thread naming functions (among others) are GNU
+// extensions, which are only used on Linux.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <poll.h>
 #include <string.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "mpsc.h"
 
@@ -34,17 +55,101 @@
 #define MPSC_SRC_FILE_NAME "mpsc.c"
 #endif
 
+// NOTE: Static tracepoints (i.e., USDT probes, under the `mpsc` provider), which are only
+// compiled in when `MPSC_USDT_ENABLED` is defined (e.g., `make library USDT=1`). Each one
+// is a single `nop` until a tracer attaches to it, and its arguments aren't evaluated
+// otherwise. See the README for the list of probes and their arguments.
+#ifdef MPSC_USDT_ENABLED
+#include <sys/sdt.h>
+#define MPSC_PROBE(name, ...) STAP_PROBEV(mpsc, name, __VA_ARGS__)
+#else
+#define MPSC_PROBE(name, ...) ((void)0)
+#endif
+
 static void my_thread_join(pthread_t id);
+static void my_thread_attributes_set_stack_size(pthread_attr_t *attributes, size_t stack_size);
+#ifdef __linux__
+static void my_thread_attributes_set_affinity(pthread_attr_t *attributes, const cpu_set_t *cpus);
+#endif
+static void my_thread_attributes_set_fifo_priority(pthread_attr_t *attributes, int priority);
+
+typedef struct my_cached_thread_s my_cached_thread_t;
+
+// NOTE: A handle for a thread that is either created for the occasion, or borrowed
+// from the process-wide thread cache (see `mpsc_thread_cache_configure`).
+typedef struct
+{
+    pthread_t id;
+    bool cached;
+    // NOTE: Only used when `cached = true`, and protected by the thread cache's mutex.
+    bool finished;
+    // NOTE: Only used for threads with custom attributes, which name themselves
+    // (see `my_named_thread_callback`) before calling `callback`.
+    void *(*callback)(void *context);
+    void *context;
+    char name[16];
+} my_thread_t;
+
+// NOTE: The internal representation of `mpsc_thread_attributes_t`, in which the CPU
+// list has been copied into a CPU set, and the name into a fixed size buffer.
+typedef struct
+{
+    bool enabled;
+    size_t stack_size;
+    bool has_affinity;
+#ifdef __linux__
+    cpu_set_t cpus;
+#endif
+    bool cpus_round_robin;
+    char name[16];
+    // NOTE: When non-zero, the thread uses the `SCHED_FIFO` policy with this priority.
+    int sched_priority;
+} my_thread_attributes_t;
+
+static void my_thread_attributes_init(my_thread_attributes_t *self, const mpsc_thread_attributes_t *attributes);
+static void my_thread_attributes_validate(const mpsc_thread_attributes_t *attributes, const char *field_name);
+static bool my_thread_start(my_thread_t *thread, void *(callback)(void *context), void *context, const my_thread_attributes_t *attributes, ssize_t index, bool handle_errors);
+static void my_thread_wait(my_thread_t *thread);
+static void *my_cached_thread_callback(void *context);
+static void my_thread_cache_reap(void);
+static void *my_named_thread_callback(void *context);
 static void my_mutex_set_lock_state(pthread_mutex_t *mutex, bool state);
 static void my_condition_variable_signal(pthread_cond_t *condition_variable);
+static void my_condition_variable_broadcast(pthread_cond_t *condition_variable);
 static void my_condition_variable_wait(pthread_cond_t *condition_variable, pthread_mutex_t *mutex);
+static bool my_condition_variable_timed_wait(pthread_cond_t *condition_variable, pthread_mutex_t *mutex, const struct timespec *deadline);
+static void my_deadline_from_timeout(struct timespec *deadline, long timeout_ms);
 static bool my_mutex_init(pthread_mutex_t *mutex, bool handle_errors);
+static bool my_mutex_init_with_attributes(pthread_mutex_t *mutex, const pthread_mutexattr_t *attributes, bool handle_errors);
+static void my_mutex_attributes_init(pthread_mutexattr_t *attributes);
+static void my_mutex_attributes_set_priority_inheritance(pthread_mutexattr_t *attributes);
+static void my_mutex_attributes_set_process_shared(pthread_mutexattr_t *attributes);
 static void my_mutex_destroy(pthread_mutex_t *mutex);
 static bool my_condition_variable_init(pthread_cond_t *condition_variable, bool handle_errors);
+static bool my_condition_variable_init_with_attributes(pthread_cond_t *condition_variable, const pthread_condattr_t *attributes, bool handle_errors);
+static void my_condition_variable_attributes_init(pthread_condattr_t *attributes);
+static void my_condition_variable_attributes_set_process_shared(pthread_condattr_t *attributes);
 static void my_condition_variable_destroy(pthread_cond_t *condition_variable);
 static bool my_thread_create(pthread_t *id, void *(callback)(void *context), void *context, bool handle_errors);
+static bool my_thread_create_with_attributes(pthread_t *id, const pthread_attr_t *attributes, void *(callback)(void *context), void *context, bool handle_errors);
 static void *my_malloc(size_t n, bool handle_errors);
 static void my_free(void *pointer);
+static void *my_pages_alloc(size_t n, bool handle_errors);
+static void my_pages_free(void *pointer, size_t n);
+static void *my_huge_pages_alloc(size_t n, size_t *mapped_size, bool handle_errors);
+static void my_huge_pages_free(void *pointer, size_t mapped_size);
+static bool my_read_all(int fd, void *buffer, size_t n);
+static void my_io_failure(const char *call, int line, const char *function);
+static int my_fdatasync(int fd);
+static uint64_t my_monotonic_ns(void);
+static void my_sleep_until_ns(uint64_t target_ns);
+static void my_counter_add(uint64_t *counter, uint64_t value);
+
+// NOTE: The huge page size assumed when aligning huge page backed buffers (i.e., the
+// default huge page size on x86-64 and most aarch64 configurations).
+#ifndef MPSC_HUGE_PAGE_SIZE
+#define MPSC_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+#endif
 
 static void *my_producer_thread_callback(void *context);
 static void *my_consumer_thread_callback(void *context);
@@ -55,14 +160,468 @@ typedef enum
     MPSC_HANDLE_CREATION_FAILURE_COND_VAR_INIT = 1,
     MPSC_HANDLE_CREATION_FAILURE_MUTEX_INIT = 2,
     MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE = 3,
+    MPSC_HANDLE_CREATION_FAILURE_IDLE_COND_VAR_INIT = 4,
 } mpsc_handle_creation_failure_type_t;
 
-static void *mpsc_handle_creation_failure(mpsc_t *self, mpsc_handle_creation_failure_type_t type, ssize_t producer_cond_var_index);
-static void mpsc_destroy(mpsc_t *self);
+static void *mpsc_mapped_storage_create(mpsc_create_params_t *params, size_t *storage_size);
+static bool mpsc_condition_variable_init(mpsc_t *self, pthread_cond_t *condition_variable);
+
+static void *mpsc_handle_creation_failure(mpsc_t *self, mpsc_handle_creation_failure_type_t type);
+static mpsc_t *mpsc_create_with_storage(mpsc_create_params_t params, void *storage);
+static void mpsc_destroy_resources(mpsc_t *self);
+static void mpsc_check_producers_done(mpsc_t *self);
 static void mpsc_create_params_validate(mpsc_create_params_t *params);
 static void mpsc_producer_done(mpsc_producer_t *self);
-static size_t mpsc_producer_subscribe_to_wait_queue(mpsc_producer_t *self);
+static void mpsc_producer_subscribe_to_wait_queue(mpsc_producer_t *self);
+static bool mpsc_producer_send_message(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n);
 static void mpsc_shift_producer_wait_queue(mpsc_t *self);
+static void mpsc_reap_finished_producers(mpsc_t *self);
+static mpsc_producer_t *mpsc_producer_slot(mpsc_t *self, size_t id);
+static size_t mpsc_producer_chunk_length(mpsc_t *self, size_t chunk_index);
+static mpsc_register_producer_error_t mpsc_producer_chunk_create(mpsc_t *self, size_t chunk_index);
+
+// NOTE: Per-producer state (i.e., the `mpsc_producer_t` objects, along with their
+// condition variables) is allocated in chunks of this many producers, as producers
+// are registered, rather than for `n_max_producers` producers up front.
+#ifndef MPSC_PRODUCER_CHUNK_SIZE
+#define MPSC_PRODUCER_CHUNK_SIZE (64)
+#endif
+static mpsc_register_producer_error_t mpsc_register_producer_with_mode(mpsc_t *self, mpsc_producer_thread_callback_t callback, void *context, bool threaded, mpsc_producer_t **out);
+static void mpsc_forward_pending_message(mpsc_t *self);
+static void mpsc_release_buffer(mpsc_t *self);
+
+typedef enum
+{
+    MPSC_TRY_SEND_STATUS_SENT = 0,
+    MPSC_TRY_SEND_STATUS_FULL = 1,
+    MPSC_TRY_SEND_STATUS_CLOSED = 2,
+} mpsc_try_send_status_t;
+
+static mpsc_try_send_status_t mpsc_producer_try_send(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n);
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t condition_variable;
+    bool notified;
+} mpsc_waiter_t;
+
+static void mpsc_waiter_init(mpsc_waiter_t *self);
+static void mpsc_waiter_destroy(mpsc_waiter_t *self);
+static void mpsc_waiter_notify(mpsc_waiter_t *self);
+static bool mpsc_waiter_wait(mpsc_waiter_t *self, const struct timespec *deadline);
+static void mpsc_notify_select_producers(mpsc_t *self);
+static void mpsc_notify_consumer(mpsc_t *self);
+static void mpsc_consumer_busy_poll(mpsc_t *self);
+
+// NOTE: The counters behind `mpsc_stats`. Each set has a single writer at a time (i.e., a producer,
+// the consumer thread or a dispatch worker), which updates it using `my_counter_add`, so that
+// `mpsc_stats` can read it concurrently without making the writers contend on a shared cache line.
+typedef struct
+{
+    uint64_t n_messages;
+    uint64_t n_bytes;
+    uint64_t n_waits;
+    uint64_t wait_time_ns;
+    uint64_t n_wakeups;
+} mpsc_producer_counters_t;
+
+// NOTE: Only allocated when `latency_histograms_enabled = true`, and recorded into the same
+// way as the counters (i.e., by a single writer at a time, using `my_counter_add`).
+typedef struct
+{
+    mpsc_histogram_t delivery;
+    mpsc_histogram_t callback;
+} mpsc_consumer_histograms_t;
+
+typedef struct
+{
+    uint64_t n_messages;
+    uint64_t n_bytes;
+    uint64_t busy_time_ns;
+    mpsc_consumer_histograms_t *histograms;
+} mpsc_delivery_counters_t;
+
+static void mpsc_producer_count_send(mpsc_producer_t *self, size_t n, uint64_t start_ns);
+static void mpsc_record_queue_depth(mpsc_t *self);
+static size_t mpsc_queue_depth(mpsc_t *self);
+static void mpsc_consumer_deliver(mpsc_t *self, mpsc_delivery_counters_t *counters, void *data, size_t n, uint64_t enqueue_ns);
+
+static uint64_t mpsc_latency_now(mpsc_t *self);
+static uint64_t mpsc_stats_now(mpsc_t *self);
+static mpsc_histogram_t *mpsc_histogram_create(mpsc_t *self);
+static mpsc_consumer_histograms_t *mpsc_consumer_histograms_create(mpsc_t *self);
+static void mpsc_histogram_init(mpsc_histogram_t *self);
+static void mpsc_histogram_record(mpsc_histogram_t *self, uint64_t value_ns);
+static void mpsc_histogram_merge(mpsc_histogram_t *self, mpsc_histogram_t *other);
+static size_t mpsc_histogram_bucket_index(uint64_t value_ns);
+
+// NOTE: Hints the CPU that the calling thread is spinning, which saves power and
+// frees resources for the sibling hyper-thread.
+#if defined(__x86_64__) || defined(__i386__)
+#define my_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define my_cpu_relax() __asm__ __volatile__("yield")
+#else
+#define my_cpu_relax() ((void)0)
+#endif
+
+// NOTE: The number of polling iterations between two checks of the clock, when a
+// busy-polling consumer thread can park (i.e., `busy_poll_idle_timeout_us > 0`).
+#ifndef MPSC_BUSY_POLL_CLOCK_INTERVAL
+#define MPSC_BUSY_POLL_CLOCK_INTERVAL (1024)
+#endif
+static void mpsc_mark_closed(mpsc_t *self);
+static mpsc_receive_status_t mpsc_try_receive(mpsc_t *self, void **data, size_t *n);
+static bool mpsc_consumer_copy_message(mpsc_t *self, void **data, size_t *n);
+
+static void mpsc_executor_schedule(mpsc_executor_t *self, mpsc_t *mpsc);
+static void mpsc_executor_run(mpsc_executor_t *self, mpsc_t *mpsc);
+static void *my_executor_thread_callback(void *context);
+
+// NOTE: The maximum number of messages delivered for a channel before an executor
+// thread moves on to the next scheduled channel, so that a busy channel can't
+// starve the others.
+#ifndef MPSC_EXECUTOR_BATCH_SIZE
+#define MPSC_EXECUTOR_BATCH_SIZE (16)
+#endif
+
+typedef struct mpsc_numa_node_s mpsc_numa_node_t;
+
+static bool mpsc_numa_create(mpsc_t *self, mpsc_create_params_t *params);
+static void mpsc_numa_destroy(mpsc_t *self);
+static size_t mpsc_numa_current_node(mpsc_t *self);
+static bool mpsc_numa_send(mpsc_producer_t *self, void *data, size_t n);
+static void mpsc_numa_consume(mpsc_t *self);
+static void mpsc_numa_drain(mpsc_t *self, mpsc_numa_node_t *node);
+
+typedef struct mpsc_dispatch_worker_s mpsc_dispatch_worker_t;
+
+static bool mpsc_dispatch_create(mpsc_t *self);
+static void mpsc_dispatch_shutdown(mpsc_t *self);
+static void mpsc_dispatch_destroy(mpsc_t *self);
+static void mpsc_dispatch_push(mpsc_dispatch_worker_t *worker, void *data, size_t n, uint64_t enqueue_ns);
+static void *my_dispatch_worker_thread_callback(void *context);
+
+static void mpsc_broadcast_create_params_validate(mpsc_broadcast_create_params_t *params);
+static mpsc_broadcast_receive_status_t mpsc_broadcast_receive_with_mode(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n, bool blocking);
+
+typedef struct mpsc_fd_poller_s mpsc_fd_poller_t;
+typedef struct mpsc_fd_source_s mpsc_fd_source_t;
+
+static mpsc_register_producer_error_t mpsc_fd_poller_create(mpsc_t *mpsc, mpsc_fd_poller_t **out);
+static mpsc_register_producer_error_t mpsc_fd_poller_add(mpsc_fd_poller_t *self, mpsc_fd_source_t *source);
+static void mpsc_fd_poller_destroy(mpsc_fd_poller_t *self);
+static void mpsc_fd_poller_wake(mpsc_t *self);
+#ifdef __linux__
+static mpsc_register_producer_error_t mpsc_fd_poller_failure(const char *call, int line, const char *function, bool handle_errors);
+static bool mpsc_fd_source_read(mpsc_fd_poller_t *self, mpsc_fd_source_t *source, bool *closed);
+static void mpsc_fd_source_remove(mpsc_fd_poller_t *self, mpsc_fd_source_t *source);
+static void *my_fd_poller_thread_callback(void *context);
+#endif
+
+// NOTE: The maximum number of bytes read from a file descriptor source at once, on top of
+// `buffer_size`, which is also the room left for framing bytes in each source's read buffer.
+#ifndef MPSC_FD_SOURCE_READ_SIZE
+#define MPSC_FD_SOURCE_READ_SIZE (4096)
+#endif
+
+// NOTE: The maximum number of events returned by each call to `epoll_wait`.
+#ifndef MPSC_FD_POLLER_BATCH_SIZE
+#define MPSC_FD_POLLER_BATCH_SIZE (64)
+#endif
+
+typedef struct mpsc_spill_s mpsc_spill_t;
+typedef struct mpsc_spill_segment_s mpsc_spill_segment_t;
+
+static bool mpsc_spill_create(mpsc_t *self, mpsc_create_params_t *params);
+static void mpsc_spill_destroy(mpsc_t *self);
+static bool mpsc_spill_is_empty(mpsc_t *self);
+static bool mpsc_spill_push(mpsc_t *self, uint64_t key_hash, void *data, size_t n);
+static bool mpsc_spill_pop(mpsc_t *self, uint64_t *key_hash, void **data, size_t *n, uint64_t *enqueue_ns);
+static void mpsc_spill_wait_until_drained(mpsc_t *self);
+static mpsc_spill_segment_t *mpsc_spill_segment_acquire(mpsc_t *self);
+static void mpsc_spill_segment_release(mpsc_spill_t *self, mpsc_spill_segment_t *segment);
+
+// NOTE: The size of spill segment files when `spill_segment_size = 0`.
+#ifndef MPSC_SPILL_SEGMENT_SIZE
+#define MPSC_SPILL_SEGMENT_SIZE ((size_t)16 * 1024 * 1024)
+#endif
+
+// NOTE: The maximum number of fully read spill segments kept mapped for reuse.
+#ifndef MPSC_SPILL_MAX_FREE_SEGMENTS
+#define MPSC_SPILL_MAX_FREE_SEGMENTS (2)
+#endif
+
+// NOTE: Each spilled message is stored as a header followed by its `n` bytes,
+// padded so that the next header is aligned.
+typedef struct
+{
+    uint64_t n;
+    uint64_t key;
+    // NOTE: 0 unless `latency_histograms_enabled = true`.
+    uint64_t enqueue_ns;
+} mpsc_spill_record_header_t;
+
+#define MPSC_SPILL_RECORD_SIZE(n) ((sizeof(mpsc_spill_record_header_t) + (n) + 7) & ~(size_t)7)
+
+typedef struct mpsc_wal_s mpsc_wal_t;
+typedef struct mpsc_wal_replay_s mpsc_wal_replay_t;
+
+typedef enum
+{
+    MPSC_WAL_RECORD_TYPE_MESSAGE = 1,
+    MPSC_WAL_RECORD_TYPE_ACK = 2,
+} mpsc_wal_record_type_t;
+
+// NOTE: Each log record is this header, followed by `n` bytes of message data.
+// For acknowledgements, `sequence` is the acknowledged sequence number, and `n = 0`.
+typedef struct
+{
+    uint64_t type;
+    uint64_t sequence;
+    uint64_t key;
+    uint64_t n;
+    uint64_t checksum;
+} mpsc_wal_record_header_t;
+
+static bool mpsc_wal_create(mpsc_t *self, mpsc_create_params_t *params);
+static void mpsc_wal_destroy(mpsc_t *self);
+static bool mpsc_wal_load(mpsc_wal_t *self, bool handle_errors);
+static uint64_t mpsc_wal_append(mpsc_t *self, uint64_t key_hash, void *data, size_t n);
+static void mpsc_wal_sync(mpsc_wal_t *self, uint64_t sequence);
+static void mpsc_wal_replay(mpsc_t *self);
+static void mpsc_wal_write_record(int fd, mpsc_wal_record_type_t type, uint64_t sequence, uint64_t key_hash, const void *data, size_t n);
+static uint64_t mpsc_wal_record_checksum(const mpsc_wal_record_header_t *header, const void *data);
+static void mpsc_wal_sync_directory(const char *path);
+
+// NOTE: The size past which the log is truncated once every message it holds has been
+// acknowledged (see `mpsc_consumer_ack`), which amortizes the sync that truncating requires.
+#ifndef MPSC_WAL_TRUNCATE_SIZE
+#define MPSC_WAL_TRUNCATE_SIZE ((uint64_t)1024 * 1024)
+#endif
+
+typedef struct mpsc_trace_ring_s mpsc_trace_ring_t;
+typedef struct mpsc_trace_replay_s mpsc_trace_replay_t;
+typedef struct mpsc_trace_replay_producer_s mpsc_trace_replay_producer_t;
+
+// NOTE: The size of each producer's trace buffer when `producer_buffer_size = 0`.
+#ifndef MPSC_TRACE_BUFFER_SIZE
+#define MPSC_TRACE_BUFFER_SIZE ((size_t)64 * 1024)
+#endif
+
+// NOTE: The trace writer thread's flush interval when `flush_interval_ms = 0`.
+#ifndef MPSC_TRACE_FLUSH_INTERVAL_MS
+#define MPSC_TRACE_FLUSH_INTERVAL_MS (10)
+#endif
+
+#define MPSC_TRACE_MAGIC "MPSCTR01"
+#define MPSC_TRACE_RECORD_FLAG_PAYLOAD (1u)
+
+// NOTE: A trace file starts with `MPSC_TRACE_MAGIC`, followed by records made of this header and, when
+// `MPSC_TRACE_RECORD_FLAG_PAYLOAD` is set, the message's `n` bytes. Each producer's records are in order,
+// but records from different producers are only ordered by their timestamp (in nanoseconds, relative to
+// the start of the recording).
+typedef struct
+{
+    uint64_t timestamp_ns;
+    uint64_t n;
+    uint32_t producer_index;
+    uint32_t flags;
+} mpsc_trace_record_header_t;
+
+static void mpsc_trace_record(mpsc_producer_t *producer, const void *data, size_t n);
+static void mpsc_trace_append(mpsc_trace_t *self, size_t producer_id, const void *data, size_t n);
+static void mpsc_trace_ring_write(mpsc_trace_t *self, mpsc_trace_ring_t *ring, uint64_t position, const void *data, size_t n);
+static void mpsc_trace_flush(mpsc_trace_t *self);
+static void mpsc_trace_write(int fd, const void *data, size_t n);
+static void *mpsc_trace_handle_creation_failure(mpsc_trace_t *self, int reason_code, bool handle_errors);
+static void *my_trace_writer_thread_callback(void *context);
+static const char *mpsc_trace_next_record(const char *file, size_t size, size_t *offset, mpsc_trace_record_header_t *header);
+static bool mpsc_trace_replay_finish(mpsc_trace_replay_t *self, int reason_code, bool handle_errors);
+static void *my_trace_replay_thread_callback(void *context);
+
+static void mpsc_bridge_create_params_validate(mpsc_bridge_create_params_t *params);
+static void *mpsc_bridge_handle_creation_failure(mpsc_bridge_t *self, int reason_code, bool handle_errors);
+static void *my_bridge_thread_callback(void *context);
+
+// NOTE: `recvmmsg` is Linux-only, so other platforms read one datagram at a time
+// into the same headers (see `my_receive_datagrams`).
+#ifdef __linux__
+typedef struct mmsghdr my_datagram_header_t;
+#else
+typedef struct
+{
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+} my_datagram_header_t;
+#endif
+
+static int my_receive_datagrams(int fd, my_datagram_header_t *headers, size_t n);
+
+struct mpsc_bridge_s
+{
+    mpsc_t *mpsc;
+    mpsc_producer_t *producer;
+    int socket_fd;
+    // NOTE: Written to by `mpsc_bridge_destroy`, to wake the bridge thread up.
+    int stop_pipe[2];
+    char path[sizeof(((struct sockaddr_un *)NULL)->sun_path)];
+    size_t batch_size;
+    // NOTE: `batch_size` frames of `buffer_size` bytes each, along with the
+    // `recvmmsg` headers that point to them.
+    char *frames;
+    struct iovec *iovecs;
+    my_datagram_header_t *headers;
+    // NOTE: Only written to by the bridge thread (see `mpsc_bridge_n_dropped_datagrams`).
+    uint64_t n_dropped_datagrams;
+    pthread_t thread;
+};
+
+struct mpsc_fd_source_s
+{
+    int fd;
+    mpsc_framing_callback_t *framing;
+    void *context;
+    // NOTE: `buffer_size + MPSC_FD_SOURCE_READ_SIZE` bytes, of which the first
+    // `length` have been read but not consumed yet.
+    char *buffer;
+    size_t length;
+    mpsc_fd_source_t *next;
+};
+
+struct mpsc_fd_poller_s
+{
+    mpsc_t *mpsc;
+    mpsc_producer_t *producer;
+    int epoll_fd;
+    // NOTE: Registered with a `NULL` pointer, and written to by `mpsc_fd_poller_wake`,
+    // so that the thread can check whether it should return.
+    int event_fd;
+    pthread_t thread;
+    // NOTE: The fields below are protected by `mutex`, which can be locked while holding the
+    // channel's mutex, but not the other way around.
+    pthread_mutex_t mutex;
+    mpsc_fd_source_t *sources;
+    size_t n_sources;
+    bool stopping;
+};
+
+struct mpsc_spill_segment_s
+{
+    char *data;
+    // NOTE: Records are appended at `write_offset`, and read back from `read_offset`.
+    size_t write_offset;
+    size_t read_offset;
+    mpsc_spill_segment_t *next;
+};
+
+struct mpsc_spill_s
+{
+    // NOTE: All fields are protected by the channel's mutex.
+    char *directory;
+    size_t segment_size;
+    // NOTE: Segments holding spilled messages, oldest first. Only `tail` is written to.
+    mpsc_spill_segment_t *head;
+    mpsc_spill_segment_t *tail;
+    mpsc_spill_segment_t *free_segments;
+    size_t n_free_segments;
+    size_t n_messages;
+    // NOTE: Broadcast by the consumer thread once `n_messages` drops to 0, for
+    // producers that failed to spill a message.
+    pthread_cond_t drained_condition_variable;
+};
+
+struct mpsc_trace_ring_s
+{
+    // NOTE: A single-producer, single-consumer byte ring: `head` is only advanced by the producer that
+    // owns the ring, and `tail` by the writer thread. Both only grow, and are taken modulo `ring_size`.
+    uint64_t head;
+    uint64_t tail;
+    uint64_t n_dropped;
+    char data[];
+};
+
+struct mpsc_trace_s
+{
+    mpsc_t *mpsc;
+    int fd;
+    bool payloads_enabled;
+    size_t ring_size;
+    long flush_interval_ms;
+    uint64_t start_ns;
+    // NOTE: One ring per producer slot, created (and published atomically) by the producer's first record.
+    mpsc_trace_ring_t **rings;
+    // NOTE: Records that were dropped because a ring couldn't be allocated (updated atomically).
+    uint64_t n_dropped;
+    pthread_t thread;
+    // NOTE: Protects `stopping`, which is used to wake the writer thread up.
+    pthread_mutex_t mutex;
+    pthread_cond_t condition_variable;
+    bool stopping;
+};
+
+struct mpsc_trace_replay_producer_s
+{
+    mpsc_trace_replay_t *replay;
+    mpsc_producer_t *producer;
+    // NOTE: Pointers to the producer's records, in the replay's copy of the trace file.
+    const char **records;
+    size_t n_records;
+    pthread_t thread;
+};
+
+struct mpsc_trace_replay_s
+{
+    mpsc_t *mpsc;
+    double speedup;
+    uint64_t start_ns;
+    char *file;
+    // NOTE: `buffer_size` zero bytes, sent in place of payloads that weren't recorded.
+    char *zeros;
+    mpsc_trace_replay_producer_t *producers;
+    size_t n_producers;
+    const char **records;
+};
+
+struct mpsc_wal_replay_s
+{
+    uint64_t sequence;
+    uint64_t key_hash;
+    void *data;
+    size_t n;
+    mpsc_wal_replay_t *next;
+};
+
+struct mpsc_wal_s
+{
+    char *path;
+    int fd;
+    // NOTE: The fields below are protected by the channel's mutex. Records are written to the log
+    // with that lock held, so sequence numbers are assigned in the log's order. Producers then hand
+    // their messages to the consumer thread in sequence order, waiting for their turn using
+    // `turn_condition_variable`, and `pending_sequence` is the internal buffer's message's.
+    uint64_t next_sequence;
+    uint64_t next_delivery_sequence;
+    uint64_t pending_sequence;
+    uint64_t acked_sequence;
+    // NOTE: The number of bytes written to the log since it was compacted or truncated.
+    uint64_t log_size;
+    pthread_cond_t turn_condition_variable;
+    // NOTE: Stored (atomically, with the channel's mutex held) once the record has been written,
+    // and loaded without it by the producer that syncs the log.
+    uint64_t written_sequence;
+    // NOTE: Protected by `sync_mutex`. While `syncing = true`, a producer is calling `fdatasync`
+    // on behalf of all the producers whose record was written when it started.
+    pthread_mutex_t sync_mutex;
+    pthread_cond_t synced_condition_variable;
+    uint64_t synced_sequence;
+    bool syncing;
+    // NOTE: Only used by the consumer thread, once the channel has been created.
+    mpsc_wal_replay_t *replay_head;
+    mpsc_wal_replay_t *replay_tail;
+    uint64_t delivered_sequence;
+};
 
 struct mpsc_consumer_s
 {
@@ -74,7 +633,50 @@ struct mpsc_producer_s
     mpsc_t *mpsc;
     void *application_context;
     bool done;
+    bool threaded;
     mpsc_producer_thread_callback_t *callback;
+    mpsc_waiter_t *select_waiter;
+    mpsc_producer_t *select_next;
+    // NOTE: The producer's slot index (see `mpsc_producer_slot`).
+    size_t id;
+    bool in_use;
+    // NOTE: Links the producer into either the finished producers list (while
+    // `in_use = true`) or the free slots list (while `in_use = false`).
+    mpsc_producer_t *slot_next;
+    my_thread_t thread;
+    pthread_cond_t condition_variable;
+    mpsc_producer_t *wait_next;
+    // NOTE: Only used in NUMA mode, where it's -1 until the producer's first send.
+    ssize_t numa_node;
+    // NOTE: Zeroed when the slot is created, and kept when it's reused, so that `mpsc_stats`
+    // also counts the messages sent by producers that are done.
+    mpsc_producer_counters_t counters;
+    // NOTE: Only set when `latency_histograms_enabled = true`, and kept when the slot is reused.
+    mpsc_histogram_t *send_histogram;
+    // NOTE: Set (atomically) while the producer is recording a message, which `mpsc_trace_stop`
+    // waits on (for each slot) after unsetting the channel's `trace`.
+    uint32_t tracing;
+};
+
+typedef struct
+{
+    void *data;
+    size_t n;
+    uint64_t enqueue_ns;
+} mpsc_dispatch_entry_t;
+
+struct mpsc_dispatch_worker_s
+{
+    mpsc_t *mpsc;
+    pthread_t thread_id;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty_condition_variable;
+    pthread_cond_t not_full_condition_variable;
+    mpsc_dispatch_entry_t *entries;
+    size_t head;
+    size_t count;
+    bool closed;
+    mpsc_delivery_counters_t counters;
 };
 
 struct mpsc_s
@@ -83,106 +685,444 @@ struct mpsc_s
     size_t n_max_producers;
     void *buffer;
     size_t n;
+    uint64_t key;
     bool pending_message;
     bool joined;
+    bool sealed;
     bool closed;
     size_t n_producers_closed;
     bool error_handling_enabled;
     bool create_and_join_thread_safety_disabled;
     pthread_t parent_thread_id;
     size_t n_producers_waiting;
-    ssize_t next_waiting_producer_id;
+    mpsc_producer_t *next_waiting_producer;
 
     pthread_mutex_t mutex;
     pthread_cond_t condition_variable;
 
-    pthread_t consumer_thread_id;
+    my_thread_t consumer_thread;
     mpsc_consumer_callback_t *consumer_callback;
     mpsc_consumer_error_callback_t *consumer_error_callback;
     mpsc_consumer_t consumer;
 
-    pthread_t *producer_thread_ids;
-    mpsc_producer_t *producers;
+    mpsc_producer_t **producer_chunks;
+    // NOTE: Only set for instances created using `mpsc_init`, in which case every
+    // producer slot lives in the application's storage, and `producer_chunks = NULL`.
+    mpsc_producer_t *producer_storage;
+    bool storage_provided;
     size_t producer_count;
-    pthread_cond_t *producer_condition_variables;
-    size_t *producer_waiting_ids_queue;
+    size_t n_producers_registered;
+    size_t n_producer_slots;
+    mpsc_producer_t *finished_producers;
+    mpsc_producer_t *free_producer_slots;
+    mpsc_producer_t *wait_queue_head;
+    mpsc_producer_t *wait_queue_tail;
+
+    size_t n_dispatch_workers;
+    size_t dispatch_queue_capacity;
+    mpsc_dispatch_worker_t *dispatch_workers;
+
+    mpsc_producer_t *select_producers;
+    bool pull_mode_enabled;
+    mpsc_waiter_t *receive_waiter;
+
+    mpsc_producer_t *downstream_producer;
+    mpsc_transform_callback_t *transform_callback;
+    void *transform_context;
+
+    mpsc_executor_t *executor;
+    bool executor_scheduled;
+    bool consumer_finished;
+    mpsc_t *executor_next;
+
+    bool reusable;
+    bool destroying;
+    size_t reset_count;
+    // NOTE: Only initialized when `reusable = true`. Used by the consumer thread to
+    // report that it's done, and to wait for the channel to be reset or destroyed.
+    pthread_cond_t idle_condition_variable;
+
+    my_thread_attributes_t consumer_thread_attributes;
+    my_thread_attributes_t producer_thread_attributes;
+
+    // NOTE: Only used in real-time and process-shared modes, in which the channel lives at the
+    // start of a memory mapping of this size (which, in real-time mode, ends with `delivery_buffer`).
+    size_t mapped_storage_size;
+    void *delivery_buffer;
+    bool process_shared;
+
+    bool busy_poll_enabled;
+    long busy_poll_idle_timeout_us;
+    // NOTE: Non-zero when `buffer` was mapped by `my_huge_pages_alloc`.
+    size_t buffer_mapped_size;
+
+    // NOTE: Created by the first call to `mpsc_register_fd_source`.
+    mpsc_fd_poller_t *fd_poller;
+    // NOTE: Only set when `spill_directory` is.
+    mpsc_spill_t *spill;
+    // NOTE: Only set when `wal_path` is.
+    mpsc_wal_t *wal;
+    // NOTE: Set (atomically) while the channel is being traced.
+    mpsc_trace_t *trace;
+    // NOTE: Incremented (atomically, with the lock held) by `mpsc_notify_consumer`, so that a
+    // busy-polling consumer thread can spin without the lock. `consumer_parked` is protected by `mutex`.
+    uint64_t consumer_notifications;
+    bool consumer_parked;
+
+    // NOTE: `delivery_counters` is only written by the thread that calls the consumer callback
+    // (or, in pull mode, with the lock held). The other two are protected by `mutex`.
+    mpsc_delivery_counters_t delivery_counters;
+    uint64_t n_consumer_wakeups;
+    size_t max_queue_depth;
+    bool stats_timing_enabled;
+    bool latency_histograms_enabled;
+    // NOTE: When the message in the internal buffer was copied there (see `mpsc_latency_now`).
+    uint64_t enqueue_ns;
+
+    size_t n_numa_nodes;
+    mpsc_numa_node_t *numa_nodes;
+    size_t numa_queue_capacity;
+    mpsc_numa_node_of_cpu_callback_t *numa_node_of_cpu;
+    void *numa_context;
+    // NOTE: Protected by `mutex`; set when a node's sub-queue goes from empty to non-empty.
+    bool numa_pending;
+};
+
+struct mpsc_numa_node_s
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t not_full_condition_variable;
+#ifdef __linux__
+    // NOTE: Only used with the topology read from sysfs.
+    cpu_set_t cpus;
+#endif
+    // NOTE: `capacity` entries of `buffer_size` bytes each, which are mapped (rather than
+    // allocated) so that their pages are untouched, and first touched by the first producer
+    // using the node, so that the kernel places them on that node.
+    char *entries;
+    size_t *sizes;
+    size_t head;
+    size_t count;
+    bool touched;
+    bool closed;
+    // NOTE: Only used by the consumer thread, to copy the entries out in bulk.
+    void **drained;
+    size_t *drained_sizes;
+};
+
+struct mpsc_executor_s
+{
+    size_t n_threads;
+    pthread_t *thread_ids;
+    size_t n_channels;
+    bool stopping;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t condition_variable;
+
+    mpsc_t *run_queue_head;
+    mpsc_t *run_queue_tail;
+};
+
+struct mpsc_broadcast_subscriber_s
+{
+    mpsc_broadcast_t *broadcast;
+    uint64_t cursor;
+    bool subscribed;
+    bool holding_message;
+};
+
+struct mpsc_broadcast_s
+{
+    size_t buffer_size;
+    size_t capacity;
+    size_t n_max_subscribers;
+    void *buffer;
+    size_t *sizes;
+    uint64_t write_sequence;
+    size_t n_subscribers;
+    bool closed;
+    // NOTE: Non-zero when `buffer` was mapped by `my_huge_pages_alloc`.
+    size_t buffer_mapped_size;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty_condition_variable;
+    pthread_cond_t not_full_condition_variable;
+
+    mpsc_broadcast_subscriber_t *subscribers;
 };
 
+_Static_assert(sizeof(mpsc_t) <= MPSC_STORAGE_HEADER_SIZE, "MPSC_STORAGE_HEADER_SIZE is too small");
+_Static_assert(sizeof(mpsc_producer_t) <= MPSC_STORAGE_PRODUCER_SIZE, "MPSC_STORAGE_PRODUCER_SIZE is too small");
+_Static_assert(MPSC_STORAGE_HEADER_SIZE % _Alignof(max_align_t) == 0, "MPSC_STORAGE_HEADER_SIZE is misaligned");
+
 mpsc_t *mpsc_create(mpsc_create_params_t params)
+{
+    return mpsc_create_with_storage(params, NULL);
+}
+
+mpsc_t *mpsc_init(void *storage, size_t storage_size, mpsc_create_params_t params)
+{
+    if ((uintptr_t)storage % _Alignof(max_align_t) != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'storage' (%p) must be aligned to %zu bytes\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, storage, _Alignof(max_align_t));
+        abort();
+    }
+    size_t required_size = MPSC_STORAGE_SIZE(params.buffer_size, params.n_max_producers);
+    if (storage_size < required_size)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'storage_size = %zu' is smaller than the required %zu bytes\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, storage_size, required_size);
+        abort();
+    }
+    return mpsc_create_with_storage(params, storage);
+}
+
+static mpsc_t *mpsc_create_with_storage(mpsc_create_params_t params, void *storage)
 {
     mpsc_create_params_validate(&params);
-    mpsc_t *self = my_malloc(sizeof(mpsc_t), params.error_handling_enabled);
+    // NOTE: The storage's layout is: the `mpsc_t` object, followed by the
+    // `n_max_producers` producer slots, followed by the message buffer.
+    size_t mapped_storage_size = 0;
+    if (
+        params.realtime_enabled ||
+        params.process_shared)
+    {
+        if (storage != NULL)
+        {
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] 'realtime_enabled = true' and 'process_shared = true' require the channel to be created using 'mpsc_create'\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__);
+            abort();
+        }
+        storage = mpsc_mapped_storage_create(&params, &mapped_storage_size);
+        if (storage == NULL)
+        {
+            return mpsc_handle_creation_failure(NULL, MPSC_HANDLE_CREATION_FAILURE_NONE);
+        }
+    }
+    if (
+        params.huge_pages_enabled &&
+        storage != NULL &&
+        !params.realtime_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'huge_pages_enabled = true' requires the channel to be created using 'mpsc_create'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    mpsc_t *self = storage;
     if (self == NULL)
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        self = my_malloc(sizeof(mpsc_t), params.error_handling_enabled);
+        if (self == NULL)
+        {
+            return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE);
+        }
+        self->storage_provided = false;
+        self->producer_storage = NULL;
+    }
+    else
+    {
+        self->storage_provided = true;
+        self->producer_storage = (mpsc_producer_t *)((char *)storage + MPSC_STORAGE_HEADER_SIZE);
     }
     self->parent_thread_id = pthread_self();
+    self->error_handling_enabled = params.error_handling_enabled;
     self->buffer_size = params.buffer_size;
     self->n_max_producers = params.n_max_producers;
     self->consumer_callback = params.consumer_callback;
     self->consumer_error_callback = params.consumer_error_callback;
     self->create_and_join_thread_safety_disabled = params.create_and_join_thread_safety_disabled;
-    self->buffer = my_malloc(params.buffer_size, params.error_handling_enabled);
-    if (self->buffer == NULL)
+    self->n_dispatch_workers = params.n_dispatch_workers;
+    self->dispatch_queue_capacity = params.dispatch_queue_capacity;
+    self->dispatch_workers = NULL;
+    self->select_producers = NULL;
+    self->pull_mode_enabled = params.pull_mode_enabled;
+    self->receive_waiter = NULL;
+    self->downstream_producer = NULL;
+    self->transform_callback = NULL;
+    self->transform_context = NULL;
+    self->executor = params.executor;
+    self->executor_scheduled = false;
+    self->consumer_finished = false;
+    self->executor_next = NULL;
+    self->reusable = params.reusable;
+    self->destroying = false;
+    self->reset_count = 0;
+    my_thread_attributes_init(&self->consumer_thread_attributes, &params.consumer_thread_attributes);
+    my_thread_attributes_init(&self->producer_thread_attributes, &params.producer_thread_attributes);
+    self->mapped_storage_size = mapped_storage_size;
+    self->delivery_buffer = NULL;
+    self->process_shared = params.process_shared;
+    if (params.realtime_enabled)
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        self->consumer_thread_attributes.sched_priority = params.realtime_priority;
+        self->consumer_thread_attributes.enabled = true;
+        self->delivery_buffer = (char *)storage + MPSC_STORAGE_SIZE(params.buffer_size, params.n_max_producers);
     }
-    self->n = 0;
-    self->n_producers_closed = 0;
-    self->producer_thread_ids = my_malloc(sizeof(pthread_t) * params.n_max_producers, params.error_handling_enabled);
-    if (self->producer_thread_ids == NULL)
+    self->producer_chunks = NULL;
+    self->n_numa_nodes = 0;
+    self->numa_nodes = NULL;
+    self->numa_queue_capacity = params.numa_queue_capacity;
+    self->numa_node_of_cpu = params.numa_node_of_cpu;
+    self->numa_context = params.numa_context;
+    self->numa_pending = false;
+    self->busy_poll_enabled = params.busy_poll_enabled;
+    self->busy_poll_idle_timeout_us = params.busy_poll_idle_timeout_us;
+    self->consumer_notifications = 0;
+    self->consumer_parked = false;
+    self->buffer_mapped_size = 0;
+    self->fd_poller = NULL;
+    self->spill = NULL;
+    self->wal = NULL;
+    self->trace = NULL;
+    self->delivery_counters = (mpsc_delivery_counters_t){0};
+    self->n_consumer_wakeups = 0;
+    self->max_queue_depth = 0;
+    self->stats_timing_enabled = params.stats_timing_enabled;
+    self->latency_histograms_enabled = params.latency_histograms_enabled;
+    self->enqueue_ns = 0;
+    if (self->storage_provided)
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        self->buffer = (char *)self->producer_storage + params.n_max_producers * MPSC_STORAGE_PRODUCER_SIZE;
     }
-    self->producers = my_malloc(sizeof(mpsc_producer_t) * params.n_max_producers, params.error_handling_enabled);
-    if (self->producers == NULL)
+    else
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        if (params.huge_pages_enabled)
+        {
+            self->buffer = my_huge_pages_alloc(params.buffer_size, &self->buffer_mapped_size, params.error_handling_enabled);
+        }
+        else
+        {
+            self->buffer = my_malloc(params.buffer_size, params.error_handling_enabled);
+        }
+        if (self->buffer == NULL)
+        {
+            return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE);
+        }
     }
-    self->producer_condition_variables = my_malloc(sizeof(pthread_cond_t) * params.n_max_producers, params.error_handling_enabled);
-    if (self->producer_condition_variables == NULL)
+    self->n = 0;
+    self->key = 0;
+    self->n_producers_closed = 0;
+    if (!self->storage_provided)
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        // NOTE: Only the (small) array of chunk pointers is allocated here; the chunks
+        // themselves are allocated by `mpsc_producer_chunk_create`, as needed.
+        size_t n_producer_chunks = (params.n_max_producers + MPSC_PRODUCER_CHUNK_SIZE - 1) / MPSC_PRODUCER_CHUNK_SIZE;
+        self->producer_chunks = my_malloc(sizeof(mpsc_producer_t *) * n_producer_chunks, params.error_handling_enabled);
+        if (self->producer_chunks == NULL)
+        {
+            return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE);
+        }
     }
-    self->producer_waiting_ids_queue = my_malloc(sizeof(size_t) * params.n_max_producers, params.error_handling_enabled);
-    if (self->producer_waiting_ids_queue == NULL)
+    if (self->latency_histograms_enabled)
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE, -1);
+        self->delivery_counters.histograms = mpsc_consumer_histograms_create(self);
+        if (self->delivery_counters.histograms == NULL)
+        {
+            return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_NONE);
+        }
     }
     self->n_producers_waiting = 0;
-    self->next_waiting_producer_id = -1;
+    self->next_waiting_producer = NULL;
+    self->wait_queue_head = NULL;
+    self->wait_queue_tail = NULL;
     self->consumer.mpsc = self;
     self->producer_count = 0;
+    self->n_producers_registered = 0;
+    self->n_producer_slots = 0;
+    self->finished_producers = NULL;
+    self->free_producer_slots = NULL;
     self->joined = false;
+    self->sealed = false;
     self->closed = false;
     self->pending_message = false;
-    self->error_handling_enabled = params.error_handling_enabled;
-    //  NOTE: The follow three calls' order is expected by `mpsc_handle_creation_failure`.
-    if (!my_condition_variable_init(&self->condition_variable, params.error_handling_enabled))
+    //  NOTE: The follow two calls' order is expected by `mpsc_handle_creation_failure`.
+    if (!mpsc_condition_variable_init(self, &self->condition_variable))
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_COND_VAR_INIT, -1);
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_COND_VAR_INIT);
     }
-    for (size_t i = 0; i < params.n_max_producers; i++)
+    bool mutex_initialized;
+    if (
+        params.realtime_enabled ||
+        params.process_shared)
     {
-        if (!my_condition_variable_init(&self->producer_condition_variables[i], params.error_handling_enabled))
+        pthread_mutexattr_t mutex_attributes;
+        my_mutex_attributes_init(&mutex_attributes);
+        if (params.realtime_enabled)
+        {
+            // NOTE: With priority inheritance, a producer holding the lock runs at the
+            // consumer thread's priority until it releases it.
+            my_mutex_attributes_set_priority_inheritance(&mutex_attributes);
+        }
+        if (params.process_shared)
         {
-            return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_COND_VAR_INIT, i);
+            my_mutex_attributes_set_process_shared(&mutex_attributes);
         }
+        mutex_initialized = my_mutex_init_with_attributes(&self->mutex, &mutex_attributes, params.error_handling_enabled);
+        pthread_mutexattr_destroy(&mutex_attributes);
+    }
+    else
+    {
+        mutex_initialized = my_mutex_init(&self->mutex, params.error_handling_enabled);
+    }
+    if (!mutex_initialized)
+    {
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_MUTEX_INIT);
+    }
+    if (
+        self->reusable &&
+        !mpsc_condition_variable_init(self, &self->idle_condition_variable))
+    {
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_IDLE_COND_VAR_INIT);
+    }
+    // NOTE: On failure, `mpsc_dispatch_create` cleans up after itself, so the remaining
+    // cleanup is the same as for a failed consumer thread creation.
+    if (self->n_dispatch_workers > 0 && !mpsc_dispatch_create(self))
+    {
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE);
+    }
+    // NOTE: Same as for `mpsc_dispatch_create`.
+    if (params.numa_enabled && !mpsc_numa_create(self, &params))
+    {
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE);
+    }
+    if (params.spill_directory != NULL && !mpsc_spill_create(self, &params))
+    {
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE);
     }
-    if (!my_mutex_init(&self->mutex, params.error_handling_enabled))
+    if (params.wal_path != NULL && !mpsc_wal_create(self, &params))
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_MUTEX_INIT, -1);
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE);
     }
 
-    if (!my_thread_create(&self->consumer_thread_id, my_consumer_thread_callback, self, params.error_handling_enabled))
+    if (
+        !params.pull_mode_enabled &&
+        params.executor == NULL &&
+        !my_thread_start(&self->consumer_thread, my_consumer_thread_callback, self, &self->consumer_thread_attributes, -1, params.error_handling_enabled))
     {
-        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE, -1);
+        return mpsc_handle_creation_failure(self, MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE);
+    }
+    if (params.executor != NULL)
+    {
+        my_mutex_set_lock_state(&params.executor->mutex, true);
+        params.executor->n_channels += 1;
+        my_mutex_set_lock_state(&params.executor->mutex, false);
     }
     return self;
 }
 
 void mpsc_join(mpsc_t *self)
 {
+    MPSC_PROBE(join_start, self);
     my_mutex_set_lock_state(&self->mutex, true);
     if (!self->create_and_join_thread_safety_disabled)
     {
@@ -205,7 +1145,9 @@ void mpsc_join(mpsc_t *self)
         abort();
     }
     self->joined = true;
-    if (self->producer_count == 0)
+    self->sealed = true;
+    mpsc_fd_poller_wake(self);
+    if (self->n_producers_registered == 0)
     {
         fprintf(
             stderr,
@@ -215,24 +1157,307 @@ void mpsc_join(mpsc_t *self)
     }
     if (self->producer_count == self->n_producers_closed)
     {
-        self->closed = true;
-        my_condition_variable_signal(&self->condition_variable);
+        mpsc_mark_closed(self);
     }
-    my_mutex_set_lock_state(&self->mutex, false);
-    my_thread_join(self->consumer_thread_id);
-    my_mutex_set_lock_state(&self->mutex, true);
-    self->closed = true;
-    my_mutex_set_lock_state(&self->mutex, false);
-    for (size_t i = 0; i < self->producer_count; i++)
+    if (self->pull_mode_enabled)
     {
-        my_thread_join(self->producer_thread_ids[i]);
+        // NOTE: There is no consumer thread to join, so we simply wait for the
+        // channel to be closed. Messages that haven't been received are dropped.
+        while (!self->closed)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+        }
+        my_mutex_set_lock_state(&self->mutex, false);
+    }
+    else if (self->executor != NULL)
+    {
+        // NOTE: Same as joining the consumer thread, except that it's the executor
+        // thread delivering the "closed" call that tells us it's done.
+        while (!self->consumer_finished)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+        }
+        my_mutex_set_lock_state(&self->mutex, false);
+    }
+    else if (self->reusable)
+    {
+        // NOTE: The consumer thread is kept (parked) for the next use of the channel,
+        // so we only wait for it to have delivered the "closed" call.
+        while (!self->consumer_finished)
+        {
+            my_condition_variable_wait(&self->idle_condition_variable, &self->mutex);
+        }
+        my_mutex_set_lock_state(&self->mutex, false);
+    }
+    else
+    {
+        my_mutex_set_lock_state(&self->mutex, false);
+        my_thread_wait(&self->consumer_thread);
+        my_mutex_set_lock_state(&self->mutex, true);
+        self->closed = true;
+        my_mutex_set_lock_state(&self->mutex, false);
+    }
+    // NOTE: Producers that have already been reaped are no longer `in_use`.
+    for (size_t i = 0; i < self->n_producer_slots; i++)
+    {
+        mpsc_producer_t *producer = mpsc_producer_slot(self, i);
+        if (
+            producer->in_use &&
+            producer->threaded)
+        {
+            my_thread_wait(&producer->thread);
+        }
+    }
+    MPSC_PROBE(join_finish, self);
+    if (self->reusable)
+    {
+        return;
+    }
+    mpsc_destroy_resources(self);
+}
+
+void mpsc_reset(mpsc_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (
+        !self->reusable ||
+        !self->joined)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] requires a reusable channel that has been joined\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    mpsc_check_producers_done(self);
+    // NOTE: Every producer thread has been joined by `mpsc_join`, and every other
+    // producer has been detached, so all of the slots are simply returned to the free list.
+    self->free_producer_slots = NULL;
+    for (size_t i = self->n_producer_slots; i > 0; i--)
+    {
+        mpsc_producer_t *producer = mpsc_producer_slot(self, i - 1);
+        producer->in_use = false;
+        producer->slot_next = self->free_producer_slots;
+        self->free_producer_slots = producer;
+    }
+    self->finished_producers = NULL;
+    self->producer_count = 0;
+    self->n_producers_closed = 0;
+    self->n_producers_registered = 0;
+    self->n = 0;
+    self->key = 0;
+    self->pending_message = false;
+    self->joined = false;
+    self->sealed = false;
+    self->closed = false;
+    self->consumer_finished = false;
+    // NOTE: An executor thread leaves the channel marked as scheduled once it has
+    // delivered the "closed" call, so that it doesn't get scheduled again.
+    self->executor_scheduled = false;
+    self->reset_count += 1;
+    my_condition_variable_broadcast(&self->idle_condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+}
+
+void mpsc_destroy(mpsc_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (
+        !self->reusable ||
+        !self->joined)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] requires a reusable channel that has been joined\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    mpsc_check_producers_done(self);
+    self->destroying = true;
+    my_condition_variable_broadcast(&self->idle_condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+    if (
+        !self->pull_mode_enabled &&
+        self->executor == NULL)
+    {
+        my_thread_wait(&self->consumer_thread);
+    }
+    mpsc_destroy_resources(self);
+}
+
+static void mpsc_check_producers_done(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held. `mpsc_join` doesn't wait for attached producers
+    // once the channel has been closed (e.g., using `mpsc_consumer_close`), and such a producer
+    // would otherwise keep using a slot (or wait in `closed = false` state) that's been recycled.
+    if (self->producer_count != self->n_producers_closed)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] %zu producer(s) still attached; every producer must be done or detached\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, self->producer_count - self->n_producers_closed);
+        abort();
+    }
+}
+
+void mpsc_seal(mpsc_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    self->sealed = true;
+    mpsc_fd_poller_wake(self);
+    if (
+        self->n_producers_registered > 0 &&
+        self->producer_count == self->n_producers_closed)
+    {
+        mpsc_mark_closed(self);
+    }
+    my_mutex_set_lock_state(&self->mutex, false);
+}
+
+mpsc_receive_status_t mpsc_receive(mpsc_t *self, long timeout_ms, void **data, size_t *n)
+{
+    size_t index;
+    return mpsc_select(&self, 1, timeout_ms, &index, data, n);
+}
+
+mpsc_receive_status_t mpsc_select(mpsc_t *channels[], size_t count, long timeout_ms, size_t *index, void **data, size_t *n)
+{
+    struct timespec deadline;
+    if (timeout_ms > 0)
+    {
+        my_deadline_from_timeout(&deadline, timeout_ms);
+    }
+    mpsc_waiter_t waiter;
+    bool waiter_initialized = false;
+    mpsc_receive_status_t status = MPSC_RECEIVE_STATUS_TIMEOUT;
+    while (true)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            status = mpsc_try_receive(channels[i], data, n);
+            if (status != MPSC_RECEIVE_STATUS_TIMEOUT)
+            {
+                *index = i;
+                break;
+            }
+        }
+        if (
+            status != MPSC_RECEIVE_STATUS_TIMEOUT ||
+            timeout_ms == 0)
+        {
+            break;
+        }
+        if (!waiter_initialized)
+        {
+            mpsc_waiter_init(&waiter);
+            waiter_initialized = true;
+        }
+        waiter.notified = false;
+        // NOTE: A message might have been sent between the attempt above and
+        // the subscription below, in which case we don't park at all.
+        for (size_t i = 0; i < count; i++)
+        {
+            mpsc_t *mpsc = channels[i];
+            my_mutex_set_lock_state(&mpsc->mutex, true);
+            if (mpsc->pending_message || mpsc->closed)
+            {
+                waiter.notified = true;
+            }
+            mpsc->receive_waiter = &waiter;
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+        }
+        bool notified = mpsc_waiter_wait(&waiter, timeout_ms > 0 ? &deadline : NULL);
+        for (size_t i = 0; i < count; i++)
+        {
+            mpsc_t *mpsc = channels[i];
+            my_mutex_set_lock_state(&mpsc->mutex, true);
+            mpsc->receive_waiter = NULL;
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+        }
+        if (!notified)
+        {
+            break;
+        }
+    }
+    if (waiter_initialized)
+    {
+        mpsc_waiter_destroy(&waiter);
+    }
+    return status;
+}
+
+static mpsc_receive_status_t mpsc_try_receive(mpsc_t *self, void **data, size_t *n)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (!self->pull_mode_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p was not created with 'pull_mode_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    if (!self->pending_message)
+    {
+        bool closed = self->closed;
+        my_mutex_set_lock_state(&self->mutex, false);
+        return closed ? MPSC_RECEIVE_STATUS_CLOSED : MPSC_RECEIVE_STATUS_TIMEOUT;
+    }
+    if (!mpsc_consumer_copy_message(self, data, n))
+    {
+        // NOTE: Unlike with the consumer thread, the message is kept, since
+        // the application can simply try again.
+        my_mutex_set_lock_state(&self->mutex, false);
+        errno = ENOMEM;
+        return MPSC_RECEIVE_STATUS_ERROR;
+    }
+    my_counter_add(&self->delivery_counters.n_messages, 1);
+    my_counter_add(&self->delivery_counters.n_bytes, *n);
+    if (self->delivery_counters.histograms != NULL)
+    {
+        mpsc_histogram_record(&self->delivery_counters.histograms->delivery, my_monotonic_ns() - self->enqueue_ns);
+    }
+    mpsc_release_buffer(self);
+    my_mutex_set_lock_state(&self->mutex, false);
+    return MPSC_RECEIVE_STATUS_MESSAGE;
+}
+
+static bool mpsc_consumer_copy_message(mpsc_t *self, void **data, size_t *n)
+{
+    // NOTE: Must be called with the lock held, while `pending_message = true`.
+    void *buffer = NULL;
+    if (
+        self->n > 0 &&
+        self->delivery_buffer != NULL)
+    {
+        // NOTE: In real-time mode, the consumer thread is the only user of the delivery
+        // buffer, and the callback returns before the next message is copied into it.
+        buffer = self->delivery_buffer;
+        memcpy(buffer, self->buffer, self->n);
+    }
+    else if (self->n > 0)
+    {
+        buffer = my_malloc(self->n, self->error_handling_enabled);
+        if (buffer == NULL)
+        {
+            return false;
+        }
+        memcpy(buffer, self->buffer, self->n);
     }
-    mpsc_destroy(self);
+    *data = buffer;
+    *n = self->n;
+    return true;
 }
 
 mpsc_register_producer_error_t mpsc_register_producer(mpsc_t *self, mpsc_producer_thread_callback_t callback, void *context)
+{
+    return mpsc_register_producer_with_mode(self, callback, context, true, NULL);
+}
+
+static mpsc_register_producer_error_t mpsc_register_producer_with_mode(mpsc_t *self, mpsc_producer_thread_callback_t callback, void *context, bool threaded, mpsc_producer_t **out)
 {
     my_mutex_set_lock_state(&self->mutex, true);
+    mpsc_reap_finished_producers(self);
     if (self->n_max_producers == self->producer_count)
     {
         my_mutex_set_lock_state(&self->mutex, false);
@@ -243,385 +1468,4863 @@ mpsc_register_producer_error_t mpsc_register_producer(mpsc_t *self, mpsc_produce
         my_mutex_set_lock_state(&self->mutex, false);
         return MPSC_REGISTER_PRODUCER_ERROR_CLOSED;
     }
-    size_t i = self->producer_count;
-    mpsc_producer_t *producer = &self->producers[i];
+    mpsc_producer_t *producer;
+    if (self->free_producer_slots != NULL)
+    {
+        producer = self->free_producer_slots;
+        self->free_producer_slots = producer->slot_next;
+    }
+    else
+    {
+        size_t id = self->n_producer_slots;
+        if (id % MPSC_PRODUCER_CHUNK_SIZE == 0)
+        {
+            mpsc_register_producer_error_t error = mpsc_producer_chunk_create(self, id / MPSC_PRODUCER_CHUNK_SIZE);
+            if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+            {
+                my_mutex_set_lock_state(&self->mutex, false);
+                return error;
+            }
+        }
+        producer = mpsc_producer_slot(self, id);
+        self->n_producer_slots += 1;
+    }
     producer->mpsc = self;
     producer->application_context = context;
     producer->done = false;
+    producer->threaded = threaded;
     producer->callback = callback;
-    pthread_t *thread_id = &self->producer_thread_ids[i];
-    if (!my_thread_create(thread_id, my_producer_thread_callback, producer, self->error_handling_enabled))
+    producer->select_waiter = NULL;
+    producer->select_next = NULL;
+    producer->wait_next = NULL;
+    producer->numa_node = -1;
+    if (
+        threaded &&
+        !my_thread_start(&producer->thread, my_producer_thread_callback, producer, &self->producer_thread_attributes, (ssize_t)producer->id, self->error_handling_enabled))
     {
+        producer->in_use = false;
+        producer->slot_next = self->free_producer_slots;
+        self->free_producer_slots = producer;
         my_mutex_set_lock_state(&self->mutex, false);
         return MPSC_REGISTER_PRODUCER_ERROR_EAGAIN;
     }
+    producer->in_use = true;
+    producer->slot_next = NULL;
     self->producer_count += 1;
+    self->n_producers_registered += 1;
+    if (out != NULL)
+    {
+        *out = producer;
+    }
     my_mutex_set_lock_state(&self->mutex, false);
     return MPSC_REGISTER_PRODUCER_ERROR_NONE;
 }
 
-mpsc_register_producer_error_t mpsc_consumer_register_producer(mpsc_consumer_t *self, mpsc_producer_thread_callback_t callback, void *context)
+mpsc_register_producer_error_t mpsc_attach_producer(mpsc_t *self, mpsc_producer_t **producer)
 {
-    return mpsc_register_producer(self->mpsc, callback, context);
+    return mpsc_register_producer_with_mode(self, NULL, NULL, false, producer);
+}
+
+void mpsc_producer_detach(mpsc_producer_t *self)
+{
+    if (self->threaded)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] producer %p was not attached using 'mpsc_attach_producer'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    mpsc_producer_done(self);
+}
+
+mpsc_register_producer_error_t mpsc_shm_attach_producer(mpsc_t *self, mpsc_producer_t **producer)
+{
+    if (!self->process_shared)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p isn't process-shared\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    return mpsc_register_producer_with_mode(self, NULL, NULL, false, producer);
+}
+
+mpsc_register_producer_error_t mpsc_register_fd_source(mpsc_t *self, int fd, mpsc_framing_callback_t *framing, void *context)
+{
+#ifndef __linux__
+    fprintf(
+        stderr,
+        "%s:%i %s [Fatal Error] file descriptor sources are only supported on Linux\n",
+        MPSC_SRC_FILE_NAME, __LINE__, __func__);
+    abort();
+#endif
+    if (self->reusable)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p is reusable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid file descriptor '%i'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, fd);
+        abort();
+    }
+    bool handle_errors = self->error_handling_enabled;
+    mpsc_fd_source_t *source = my_malloc(sizeof(mpsc_fd_source_t), handle_errors);
+    char *buffer = source == NULL ? NULL : my_malloc(self->buffer_size + MPSC_FD_SOURCE_READ_SIZE, handle_errors);
+    if (buffer == NULL)
+    {
+        my_free(source);
+        return MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+    }
+    source->fd = fd;
+    source->framing = framing;
+    source->context = context;
+    source->buffer = buffer;
+    source->length = 0;
+    source->next = NULL;
+    // NOTE: The poller's producer is attached without holding the lock (which attaching
+    // requires), so two concurrent first registrations might both create one, in which
+    // case the extra one is simply destroyed.
+    my_mutex_set_lock_state(&self->mutex, true);
+    bool has_poller = self->fd_poller != NULL;
+    my_mutex_set_lock_state(&self->mutex, false);
+    mpsc_fd_poller_t *poller = NULL;
+    if (!has_poller)
+    {
+        mpsc_register_producer_error_t error = mpsc_fd_poller_create(self, &poller);
+        if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+        {
+            my_free(buffer);
+            my_free(source);
+            return error;
+        }
+    }
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (
+        self->sealed ||
+        self->closed)
+    {
+        my_mutex_set_lock_state(&self->mutex, false);
+        if (poller != NULL)
+        {
+            mpsc_fd_poller_destroy(poller);
+        }
+        my_free(buffer);
+        my_free(source);
+        return MPSC_REGISTER_PRODUCER_ERROR_CLOSED;
+    }
+    if (self->fd_poller == NULL)
+    {
+        self->fd_poller = poller;
+        poller = NULL;
+    }
+    // NOTE: The file descriptor is only switched to non-blocking mode once the source
+    // has been accepted, and restored if it can't be polled, since the application still
+    // owns it after a failed registration.
+    mpsc_fd_poller_t *fd_poller = self->fd_poller;
+    my_mutex_set_lock_state(&fd_poller->mutex, true);
+    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)
+    {
+        my_io_failure("fcntl", __LINE__, __func__);
+    }
+    mpsc_register_producer_error_t error = mpsc_fd_poller_add(fd_poller, source);
+    if (error == MPSC_REGISTER_PRODUCER_ERROR_NONE)
+    {
+        source->next = fd_poller->sources;
+        fd_poller->sources = source;
+        fd_poller->n_sources += 1;
+    }
+    else if (fcntl(fd, F_SETFL, flags) != 0)
+    {
+        my_io_failure("fcntl", __LINE__, __func__);
+    }
+    my_mutex_set_lock_state(&fd_poller->mutex, false);
+    my_mutex_set_lock_state(&self->mutex, false);
+    if (poller != NULL)
+    {
+        mpsc_fd_poller_destroy(poller);
+    }
+    if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+    {
+        my_free(buffer);
+        my_free(source);
+    }
+    return error;
+}
+
+mpsc_register_producer_error_t mpsc_connect(mpsc_t *upstream, mpsc_t *downstream, mpsc_transform_callback_t *transform, void *context)
+{
+    if (upstream == downstream)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] a channel can't be connected to itself\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        upstream->process_shared ||
+        downstream->process_shared)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] process-shared channels can't be connected\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->pull_mode_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't use pull mode\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->executor != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't be bound to an executor\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->numa_nodes != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't use NUMA mode\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->spill != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't spill to disk\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->wal != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't be durable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->reusable)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't be reusable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (upstream->n_dispatch_workers > 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel can't use dispatch workers\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    my_mutex_set_lock_state(&upstream->mutex, true);
+    if (upstream->downstream_producer != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] upstream channel %p is already connected\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)upstream);
+        abort();
+    }
+    // NOTE: The upstream's consumer thread acts as a (threadless) producer of the
+    // downstream channel, so that it's accounted for when the downstream channel
+    // decides whether all of its producers are done.
+    mpsc_producer_t *producer = NULL;
+    mpsc_register_producer_error_t error = mpsc_attach_producer(downstream, &producer);
+    if (error == MPSC_REGISTER_PRODUCER_ERROR_NONE)
+    {
+        upstream->downstream_producer = producer;
+        upstream->transform_callback = transform;
+        upstream->transform_context = context;
+    }
+    my_mutex_set_lock_state(&upstream->mutex, false);
+    return error;
+}
+
+mpsc_register_producer_error_t mpsc_consumer_register_producer(mpsc_consumer_t *self, mpsc_producer_thread_callback_t callback, void *context)
+{
+    return mpsc_register_producer(self->mpsc, callback, context);
+}
+
+void mpsc_consumer_close(mpsc_consumer_t *self)
+{
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    mpsc_mark_closed(self->mpsc);
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+}
+
+uint64_t mpsc_consumer_sequence(mpsc_consumer_t *self)
+{
+    if (self->mpsc->wal == NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p isn't durable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self->mpsc);
+        abort();
+    }
+    return self->mpsc->wal->delivered_sequence;
+}
+
+void mpsc_consumer_ack(mpsc_consumer_t *self, uint64_t sequence)
+{
+    mpsc_wal_t *wal = self->mpsc->wal;
+    if (wal == NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p isn't durable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self->mpsc);
+        abort();
+    }
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    if (
+        sequence == 0 ||
+        sequence >= wal->next_sequence)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'sequence = %" PRIu64 "' was never assigned to a message\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, sequence);
+        abort();
+    }
+    if (sequence <= wal->acked_sequence)
+    {
+        my_mutex_set_lock_state(&self->mpsc->mutex, false);
+        return;
+    }
+    wal->acked_sequence = sequence;
+    // NOTE: Once every message in the log has been acknowledged, the log only needs
+    // to remember the last sequence number, so that the numbering resumes from there.
+    // Since truncating requires a sync, it's only done once the log has grown past
+    // `MPSC_WAL_TRUNCATE_SIZE`, so that a consumer that keeps up doesn't sync on every
+    // acknowledgement.
+    bool truncated =
+        sequence + 1 == wal->next_sequence &&
+        wal->log_size >= MPSC_WAL_TRUNCATE_SIZE;
+    if (truncated)
+    {
+        if (ftruncate(wal->fd, 0) != 0)
+        {
+            my_io_failure("ftruncate", __LINE__, __func__);
+        }
+        wal->log_size = 0;
+    }
+    mpsc_wal_write_record(wal->fd, MPSC_WAL_RECORD_TYPE_ACK, sequence, 0, NULL, 0);
+    wal->log_size += sizeof(mpsc_wal_record_header_t);
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    // NOTE: The truncation is durable once the file's size is synced, so the acknowledgement
+    // is synced along with it, else a crash could leave an empty log, and the numbering
+    // would restart from 1. The lock isn't held, so producers keep appending (and syncing)
+    // in the meantime, since their records are written after the acknowledgement.
+    if (
+        truncated &&
+        my_fdatasync(wal->fd) != 0)
+    {
+        my_io_failure("fdatasync", __LINE__, __func__);
+    }
+}
+
+void mpsc_stats(mpsc_t *self, mpsc_stats_t *out)
+{
+    mpsc_stats_t stats = {0};
+    my_mutex_set_lock_state(&self->mutex, true);
+    // NOTE: Holding the lock keeps producer slots from being created while they're summed.
+    for (size_t i = 0; i < self->n_producer_slots; i++)
+    {
+        mpsc_producer_counters_t *counters = &mpsc_producer_slot(self, i)->counters;
+        stats.n_messages_sent += __atomic_load_n(&counters->n_messages, __ATOMIC_RELAXED);
+        stats.n_bytes_sent += __atomic_load_n(&counters->n_bytes, __ATOMIC_RELAXED);
+        stats.n_sends_waited += __atomic_load_n(&counters->n_waits, __ATOMIC_RELAXED);
+        stats.wait_time_ns += __atomic_load_n(&counters->wait_time_ns, __ATOMIC_RELAXED);
+        stats.n_producer_wakeups += __atomic_load_n(&counters->n_wakeups, __ATOMIC_RELAXED);
+    }
+    size_t n_delivery_counters = 1 + (self->dispatch_workers != NULL ? self->n_dispatch_workers : 0);
+    for (size_t i = 0; i < n_delivery_counters; i++)
+    {
+        mpsc_delivery_counters_t *counters = i == 0 ? &self->delivery_counters : &self->dispatch_workers[i - 1].counters;
+        stats.n_messages_delivered += __atomic_load_n(&counters->n_messages, __ATOMIC_RELAXED);
+        stats.n_bytes_delivered += __atomic_load_n(&counters->n_bytes, __ATOMIC_RELAXED);
+        stats.consumer_busy_time_ns += __atomic_load_n(&counters->busy_time_ns, __ATOMIC_RELAXED);
+    }
+    stats.queue_depth = mpsc_queue_depth(self);
+    stats.max_queue_depth = self->max_queue_depth;
+    stats.n_consumer_wakeups = self->n_consumer_wakeups;
+    my_mutex_set_lock_state(&self->mutex, false);
+    *out = stats;
+}
+
+static void mpsc_producer_count_send(mpsc_producer_t *self, size_t n, uint64_t start_ns)
+{
+    my_counter_add(&self->counters.n_messages, 1);
+    my_counter_add(&self->counters.n_bytes, n);
+    if (self->send_histogram != NULL)
+    {
+        mpsc_histogram_record(self->send_histogram, my_monotonic_ns() - start_ns);
+    }
+}
+
+static size_t mpsc_queue_depth(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held.
+    size_t depth = (self->pending_message ? 1 : 0) + self->n_producers_waiting;
+    if (self->spill != NULL)
+    {
+        depth += self->spill->n_messages;
+    }
+    return depth;
+}
+
+static void mpsc_record_queue_depth(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held, right after a message was queued.
+    size_t depth = mpsc_queue_depth(self);
+    if (depth > self->max_queue_depth)
+    {
+        self->max_queue_depth = depth;
+    }
+}
+
+static void mpsc_consumer_deliver(mpsc_t *self, mpsc_delivery_counters_t *counters, void *data, size_t n, uint64_t enqueue_ns)
+{
+    // NOTE: The callback takes ownership of `data`, so only `n` is used once it returns.
+    // `enqueue_ns` is 0 when the message's enqueue time isn't known.
+    uint64_t start_ns = mpsc_stats_now(self);
+    if (
+        counters->histograms != NULL &&
+        enqueue_ns != 0)
+    {
+        mpsc_histogram_record(&counters->histograms->delivery, start_ns - enqueue_ns);
+    }
+    MPSC_PROBE(callback_start, self, n);
+    (self->consumer_callback)(&self->consumer, data, n, false);
+    uint64_t busy_time_ns = mpsc_stats_now(self) - start_ns;
+    MPSC_PROBE(callback_end, self, n, busy_time_ns);
+    my_counter_add(&counters->busy_time_ns, busy_time_ns);
+    my_counter_add(&counters->n_messages, 1);
+    my_counter_add(&counters->n_bytes, n);
+    if (counters->histograms != NULL)
+    {
+        mpsc_histogram_record(&counters->histograms->callback, busy_time_ns);
+    }
+}
+
+void mpsc_latency_histograms(mpsc_t *self, mpsc_latency_histograms_t *out)
+{
+    if (!self->latency_histograms_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p was not created with 'latency_histograms_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    mpsc_histogram_init(&out->send);
+    mpsc_histogram_init(&out->delivery);
+    mpsc_histogram_init(&out->callback);
+    my_mutex_set_lock_state(&self->mutex, true);
+    for (size_t i = 0; i < self->n_producer_slots; i++)
+    {
+        mpsc_histogram_merge(&out->send, mpsc_producer_slot(self, i)->send_histogram);
+    }
+    size_t n_delivery_counters = 1 + (self->dispatch_workers != NULL ? self->n_dispatch_workers : 0);
+    for (size_t i = 0; i < n_delivery_counters; i++)
+    {
+        mpsc_consumer_histograms_t *histograms = i == 0 ? self->delivery_counters.histograms : self->dispatch_workers[i - 1].counters.histograms;
+        mpsc_histogram_merge(&out->delivery, &histograms->delivery);
+        mpsc_histogram_merge(&out->callback, &histograms->callback);
+    }
+    my_mutex_set_lock_state(&self->mutex, false);
+    mpsc_histogram_t *histograms[] = {&out->send, &out->delivery, &out->callback};
+    for (size_t i = 0; i < sizeof(histograms) / sizeof(histograms[0]); i++)
+    {
+        if (histograms[i]->n_samples == 0)
+        {
+            histograms[i]->min_ns = 0;
+        }
+    }
+}
+
+uint64_t mpsc_histogram_percentile(const mpsc_histogram_t *self, double percentile)
+{
+    if (
+        !(percentile >= 0.0) ||
+        percentile > 100.0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'percentile = %f'; must be between 0 and 100\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, percentile);
+        abort();
+    }
+    if (self->n_samples == 0)
+    {
+        return 0;
+    }
+    // NOTE: The rank is rounded up, so that, e.g., the p100 is the largest value.
+    double target = percentile / 100.0 * (double)self->n_samples;
+    uint64_t rank = (uint64_t)target;
+    if (
+        (double)rank < target ||
+        rank == 0)
+    {
+        rank += 1;
+    }
+    uint64_t n_samples = 0;
+    for (size_t i = 0; i < MPSC_HISTOGRAM_N_BUCKETS; i++)
+    {
+        n_samples += self->counts[i];
+        if (n_samples >= rank)
+        {
+            uint64_t value = mpsc_histogram_bucket_upper_bound(i);
+            if (value > self->max_ns)
+            {
+                value = self->max_ns;
+            }
+            return value < self->min_ns ? self->min_ns : value;
+        }
+    }
+    return self->max_ns;
+}
+
+uint64_t mpsc_histogram_bucket_upper_bound(size_t index)
+{
+    if (index >= MPSC_HISTOGRAM_N_BUCKETS)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'index = %zu'; must be smaller than %zu\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, index, MPSC_HISTOGRAM_N_BUCKETS);
+        abort();
+    }
+    size_t n_sub_buckets = (size_t)1 << MPSC_HISTOGRAM_SUB_BUCKET_BITS;
+    if (index < n_sub_buckets)
+    {
+        return index;
+    }
+    // NOTE: See `mpsc_histogram_bucket_index`. The bucket covers `2^shift` values.
+    unsigned shift = (unsigned)(index >> MPSC_HISTOGRAM_SUB_BUCKET_BITS) - 1;
+    uint64_t lower_bound = (uint64_t)(n_sub_buckets + (index & (n_sub_buckets - 1))) << shift;
+    return lower_bound + (((uint64_t)1 << shift) - 1);
+}
+
+static uint64_t mpsc_latency_now(mpsc_t *self)
+{
+    // NOTE: Keeps the clock reads off the default path.
+    return self->latency_histograms_enabled ? my_monotonic_ns() : 0;
+}
+
+static uint64_t mpsc_stats_now(mpsc_t *self)
+{
+    // NOTE: Same as `mpsc_latency_now`, for the durations reported by `mpsc_stats`, which
+    // stay at 0 by default. The callback histogram needs the consumer callback's duration.
+    return self->stats_timing_enabled || self->latency_histograms_enabled ? my_monotonic_ns() : 0;
+}
+
+static mpsc_histogram_t *mpsc_histogram_create(mpsc_t *self)
+{
+    mpsc_histogram_t *histogram = my_malloc(sizeof(mpsc_histogram_t), self->error_handling_enabled);
+    if (histogram != NULL)
+    {
+        mpsc_histogram_init(histogram);
+    }
+    return histogram;
+}
+
+static mpsc_consumer_histograms_t *mpsc_consumer_histograms_create(mpsc_t *self)
+{
+    mpsc_consumer_histograms_t *histograms = my_malloc(sizeof(mpsc_consumer_histograms_t), self->error_handling_enabled);
+    if (histograms != NULL)
+    {
+        mpsc_histogram_init(&histograms->delivery);
+        mpsc_histogram_init(&histograms->callback);
+    }
+    return histograms;
+}
+
+static void mpsc_histogram_init(mpsc_histogram_t *self)
+{
+    memset(self, 0, sizeof(mpsc_histogram_t));
+    self->min_ns = UINT64_MAX;
+}
+
+static void mpsc_histogram_record(mpsc_histogram_t *self, uint64_t value_ns)
+{
+    // NOTE: `n_samples` is only computed when merging (i.e., as the sum of `counts`), so
+    // that it always matches the counts it's returned with.
+    my_counter_add(&self->counts[mpsc_histogram_bucket_index(value_ns)], 1);
+    my_counter_add(&self->total_ns, value_ns);
+    if (value_ns < __atomic_load_n(&self->min_ns, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&self->min_ns, value_ns, __ATOMIC_RELAXED);
+    }
+    if (value_ns > __atomic_load_n(&self->max_ns, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&self->max_ns, value_ns, __ATOMIC_RELAXED);
+    }
+}
+
+static void mpsc_histogram_merge(mpsc_histogram_t *self, mpsc_histogram_t *other)
+{
+    for (size_t i = 0; i < MPSC_HISTOGRAM_N_BUCKETS; i++)
+    {
+        uint64_t count = __atomic_load_n(&other->counts[i], __ATOMIC_RELAXED);
+        self->counts[i] += count;
+        self->n_samples += count;
+    }
+    self->total_ns += __atomic_load_n(&other->total_ns, __ATOMIC_RELAXED);
+    uint64_t min_ns = __atomic_load_n(&other->min_ns, __ATOMIC_RELAXED);
+    uint64_t max_ns = __atomic_load_n(&other->max_ns, __ATOMIC_RELAXED);
+    self->min_ns = min_ns < self->min_ns ? min_ns : self->min_ns;
+    self->max_ns = max_ns > self->max_ns ? max_ns : self->max_ns;
+}
+
+static size_t mpsc_histogram_bucket_index(uint64_t value_ns)
+{
+    // NOTE: Values below `2^MPSC_HISTOGRAM_SUB_BUCKET_BITS` get a bucket each. Above that, the
+    // buckets split each power of two in `2^MPSC_HISTOGRAM_SUB_BUCKET_BITS`, using the bits that
+    // follow the most significant one, as in HdrHistogram.
+    uint64_t max_value = ((uint64_t)1 << (MPSC_HISTOGRAM_MAX_EXPONENT + 1)) - 1;
+    if (value_ns > max_value)
+    {
+        value_ns = max_value;
+    }
+    size_t n_sub_buckets = (size_t)1 << MPSC_HISTOGRAM_SUB_BUCKET_BITS;
+    if (value_ns < n_sub_buckets)
+    {
+        return (size_t)value_ns;
+    }
+    unsigned exponent = 63 - (unsigned)__builtin_clzll(value_ns);
+    unsigned shift = exponent - MPSC_HISTOGRAM_SUB_BUCKET_BITS;
+    return ((size_t)(shift + 1) << MPSC_HISTOGRAM_SUB_BUCKET_BITS) + (size_t)((value_ns >> shift) & (n_sub_buckets - 1));
+}
+
+bool mpsc_producer_ping(mpsc_producer_t *self)
+{
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    bool ok = true;
+    if (self->mpsc->closed)
+    {
+        ok = false;
+    }
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    return ok;
+}
+
+bool mpsc_producer_send(mpsc_producer_t *self, void *data, size_t n)
+{
+    return mpsc_producer_send_keyed(self, 0, data, n);
+}
+
+bool mpsc_producer_send_keyed(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n)
+{
+    MPSC_PROBE(send_start, self->mpsc, self->id, n);
+    bool sent = mpsc_producer_send_message(self, key_hash, data, n);
+    if (sent)
+    {
+        // NOTE: Only messages that were actually sent are recorded.
+        mpsc_trace_record(self, data, n);
+    }
+    MPSC_PROBE(send_finish, self->mpsc, self->id, n, (int)sent);
+    return sent;
+}
+
+static bool mpsc_producer_send_message(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n)
+{
+    if (n > self->mpsc->buffer_size)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'n = %zu' is greater than 'buffer_size = %zu'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, n, self->mpsc->buffer_size);
+        abort();
+    }
+    uint64_t start_ns = mpsc_latency_now(self->mpsc);
+    if (self->mpsc->numa_nodes != NULL)
+    {
+        // NOTE: Keys are only used by dispatch workers, which NUMA mode excludes.
+        bool sent = mpsc_numa_send(self, data, n);
+        if (sent)
+        {
+            mpsc_producer_count_send(self, n, start_ns);
+        }
+        return sent;
+    }
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    if (self->mpsc->closed)
+    {
+        my_mutex_set_lock_state(&self->mpsc->mutex, false);
+        return false;
+    }
+    // NOTE: In spill-to-disk mode, a message that would have to wait is spilled instead,
+    // as is any message sent while the spill isn't empty, so that it can't overtake the
+    // spilled ones. The consumer thread only reads from the spill while the internal
+    // buffer is empty, and waiting producers are older than spilled messages.
+    if (self->mpsc->spill != NULL)
+    {
+        if (
+            (self->mpsc->pending_message || self->mpsc->next_waiting_producer != NULL || !mpsc_spill_is_empty(self->mpsc)) &&
+            mpsc_spill_push(self->mpsc, key_hash, data, n))
+        {
+            mpsc_record_queue_depth(self->mpsc);
+            mpsc_notify_consumer(self->mpsc);
+            my_mutex_set_lock_state(&self->mpsc->mutex, false);
+            mpsc_producer_count_send(self, n, start_ns);
+            return true;
+        }
+        mpsc_spill_wait_until_drained(self->mpsc);
+        if (self->mpsc->closed)
+        {
+            my_mutex_set_lock_state(&self->mpsc->mutex, false);
+            return false;
+        }
+    }
+    // NOTE: In durable mode, the message is logged and synced (without holding the lock,
+    // so that concurrent producers share the sync), and then handed to the consumer thread
+    // in sequence order. If the channel gets closed in between, the message is delivered
+    // by the next channel created with the same log.
+    uint64_t wal_sequence = 0;
+    if (self->mpsc->wal != NULL)
+    {
+        mpsc_wal_t *wal = self->mpsc->wal;
+        wal_sequence = mpsc_wal_append(self->mpsc, key_hash, data, n);
+        my_mutex_set_lock_state(&self->mpsc->mutex, false);
+        mpsc_wal_sync(wal, wal_sequence);
+        my_mutex_set_lock_state(&self->mpsc->mutex, true);
+        while (
+            !self->mpsc->closed &&
+            wal->next_delivery_sequence != wal_sequence)
+        {
+            my_condition_variable_wait(&wal->turn_condition_variable, &self->mpsc->mutex);
+        }
+        if (self->mpsc->closed)
+        {
+            my_mutex_set_lock_state(&self->mpsc->mutex, false);
+            return false;
+        }
+    }
+    // NOTE: Checking for these two conditions here is very important, else
+    // some races will occur when we have a waiting producer that gets signaled
+    // but at the same time a new message is free of sending because `message_pending = false`.
+    // What happens is that the "free" sent message gets overriden by the waiting one.
+    if (self->mpsc->pending_message || self->mpsc->next_waiting_producer != NULL)
+    {
+        mpsc_producer_subscribe_to_wait_queue(self);
+        uint64_t wait_start_ns = mpsc_stats_now(self->mpsc);
+        while (
+            !self->mpsc->closed &&
+            self->mpsc->next_waiting_producer != self)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mpsc->mutex);
+            my_counter_add(&self->counters.n_wakeups, 1);
+            MPSC_PROBE(wait_wake, self->mpsc, self->id, (int)(self->mpsc->next_waiting_producer == self));
+        }
+        my_counter_add(&self->counters.n_waits, 1);
+        my_counter_add(&self->counters.wait_time_ns, mpsc_stats_now(self->mpsc) - wait_start_ns);
+        if (self->mpsc->closed)
+        {
+            my_mutex_set_lock_state(&self->mpsc->mutex, false);
+            return false;
+        }
+        //  NOTE: Technically, once closed, shifting this no longer
+        //  helps, because the condition does necessarily mean that
+        //  `self->mpsc->next_waiting_producer != self`. On
+        //  the other hand, if the while loop breaks because it's our turn,
+        //  then we know shifting is for the appropriate waiting producer.
+        mpsc_shift_producer_wait_queue(self->mpsc);
+    }
+    if (n > 0)
+    {
+        memcpy(self->mpsc->buffer, data, n);
+    }
+    self->mpsc->n = n;
+    self->mpsc->key = key_hash;
+    self->mpsc->pending_message = true;
+    self->mpsc->enqueue_ns = mpsc_latency_now(self->mpsc);
+    if (self->mpsc->wal != NULL)
+    {
+        self->mpsc->wal->pending_sequence = wal_sequence;
+        self->mpsc->wal->next_delivery_sequence += 1;
+        my_condition_variable_broadcast(&self->mpsc->wal->turn_condition_variable);
+    }
+    mpsc_record_queue_depth(self->mpsc);
+    mpsc_notify_consumer(self->mpsc);
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    mpsc_producer_count_send(self, n, start_ns);
+    return true;
+}
+
+bool mpsc_producer_send_empty(mpsc_producer_t *self)
+{
+    return mpsc_producer_send(self, NULL, 0);
+}
+
+ssize_t mpsc_send_any(mpsc_producer_t *producers[], size_t count, void *data, size_t n)
+{
+    mpsc_waiter_t waiter;
+    bool waiter_initialized = false;
+    ssize_t index = -1;
+    while (true)
+    {
+        size_t n_closed = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            mpsc_try_send_status_t status = mpsc_producer_try_send(producers[i], 0, data, n);
+            if (status == MPSC_TRY_SEND_STATUS_SENT)
+            {
+                index = (ssize_t)i;
+                break;
+            }
+            if (status == MPSC_TRY_SEND_STATUS_CLOSED)
+            {
+                n_closed += 1;
+            }
+        }
+        if (index != -1 || n_closed == count)
+        {
+            break;
+        }
+        if (!waiter_initialized)
+        {
+            mpsc_waiter_init(&waiter);
+            waiter_initialized = true;
+        }
+        waiter.notified = false;
+        // NOTE: The buffer might have been released between the attempt above and
+        // the subscription below, in which case we don't park at all.
+        for (size_t i = 0; i < count; i++)
+        {
+            mpsc_t *mpsc = producers[i]->mpsc;
+            my_mutex_set_lock_state(&mpsc->mutex, true);
+            if (
+                mpsc->closed ||
+                (!mpsc->pending_message && mpsc->next_waiting_producer == NULL))
+            {
+                waiter.notified = true;
+            }
+            producers[i]->select_waiter = &waiter;
+            producers[i]->select_next = mpsc->select_producers;
+            mpsc->select_producers = producers[i];
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+        }
+        mpsc_waiter_wait(&waiter, NULL);
+        for (size_t i = 0; i < count; i++)
+        {
+            mpsc_t *mpsc = producers[i]->mpsc;
+            my_mutex_set_lock_state(&mpsc->mutex, true);
+            mpsc_producer_t **link = &mpsc->select_producers;
+            while (*link != producers[i])
+            {
+                link = &(*link)->select_next;
+            }
+            *link = producers[i]->select_next;
+            producers[i]->select_waiter = NULL;
+            producers[i]->select_next = NULL;
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+        }
+    }
+    if (waiter_initialized)
+    {
+        mpsc_waiter_destroy(&waiter);
+    }
+    return index;
+}
+
+static mpsc_try_send_status_t mpsc_producer_try_send(mpsc_producer_t *self, uint64_t key_hash, void *data, size_t n)
+{
+    if (self->mpsc->numa_nodes != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p uses NUMA mode\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self->mpsc);
+        abort();
+    }
+    if (self->mpsc->process_shared)
+    {
+        // NOTE: `mpsc_send_any`'s waiter lives in the calling process' memory, where
+        // a consumer thread running in another process can't notify it.
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p is process-shared\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self->mpsc);
+        abort();
+    }
+    if (self->mpsc->wal != NULL)
+    {
+        // NOTE: A logged message can't be taken back if the internal buffer turns out to be full.
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p is durable\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self->mpsc);
+        abort();
+    }
+    uint64_t start_ns = mpsc_latency_now(self->mpsc);
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    if (n > self->mpsc->buffer_size)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'n = %zu' is greater than 'buffer_size = %zu'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, n, self->mpsc->buffer_size);
+        abort();
+    }
+    if (self->mpsc->closed)
+    {
+        my_mutex_set_lock_state(&self->mpsc->mutex, false);
+        return MPSC_TRY_SEND_STATUS_CLOSED;
+    }
+    // NOTE: Same as in `mpsc_producer_send_keyed`, a producer that was signaled
+    // (i.e., `next_waiting_producer`) owns the buffer, even if it's empty. In
+    // spill-to-disk mode, the message is spilled instead, when possible.
+    if (self->mpsc->pending_message || self->mpsc->next_waiting_producer != NULL || !mpsc_spill_is_empty(self->mpsc))
+    {
+        bool spilled = mpsc_spill_push(self->mpsc, key_hash, data, n);
+        if (spilled)
+        {
+            mpsc_record_queue_depth(self->mpsc);
+            mpsc_notify_consumer(self->mpsc);
+        }
+        my_mutex_set_lock_state(&self->mpsc->mutex, false);
+        if (spilled)
+        {
+            mpsc_trace_record(self, data, n);
+            mpsc_producer_count_send(self, n, start_ns);
+        }
+        return spilled ? MPSC_TRY_SEND_STATUS_SENT : MPSC_TRY_SEND_STATUS_FULL;
+    }
+    if (n > 0)
+    {
+        memcpy(self->mpsc->buffer, data, n);
+    }
+    self->mpsc->n = n;
+    self->mpsc->key = key_hash;
+    self->mpsc->pending_message = true;
+    self->mpsc->enqueue_ns = mpsc_latency_now(self->mpsc);
+    mpsc_record_queue_depth(self->mpsc);
+    mpsc_notify_consumer(self->mpsc);
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    mpsc_trace_record(self, data, n);
+    mpsc_producer_count_send(self, n, start_ns);
+    return MPSC_TRY_SEND_STATUS_SENT;
+}
+
+static void mpsc_release_buffer(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held, once the consumer is done with the
+    // internal buffer. Producers waiting in the queue have priority over those
+    // waiting inside `mpsc_send_any`.
+    self->n = 0;
+    self->key = 0;
+    self->pending_message = false;
+    if (self->wait_queue_head != NULL && !self->closed)
+    {
+        self->next_waiting_producer = self->wait_queue_head;
+        my_condition_variable_signal(&self->wait_queue_head->condition_variable);
+    }
+    else
+    {
+        mpsc_notify_select_producers(self);
+    }
+}
+
+static void mpsc_notify_select_producers(mpsc_t *self)
+{
+    for (mpsc_producer_t *producer = self->select_producers; producer != NULL; producer = producer->select_next)
+    {
+        mpsc_waiter_notify(producer->select_waiter);
+    }
+}
+
+static void mpsc_notify_consumer(mpsc_t *self)
+{
+    if (self->busy_poll_enabled)
+    {
+        __atomic_store_n(&self->consumer_notifications, self->consumer_notifications + 1, __ATOMIC_RELEASE);
+    }
+    // NOTE: The condition variable is still used by `mpsc_join` in some modes, but
+    // busy polling excludes those.
+    if (
+        !self->busy_poll_enabled ||
+        self->consumer_parked)
+    {
+        my_condition_variable_signal(&self->condition_variable);
+    }
+    if (self->receive_waiter != NULL)
+    {
+        mpsc_waiter_notify(self->receive_waiter);
+    }
+    if (
+        self->executor != NULL &&
+        !self->executor_scheduled &&
+        !self->consumer_finished)
+    {
+        self->executor_scheduled = true;
+        mpsc_executor_schedule(self->executor, self);
+    }
+}
+
+static void mpsc_mark_closed(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held. Everyone who might be waiting on the
+    // channel is woken up, so that they can observe `closed = true`. Since no
+    // producer can join the wait queue once closed, the queue is simply dropped.
+    self->closed = true;
+    MPSC_PROBE(close, self);
+    mpsc_notify_consumer(self);
+    if (self->wal != NULL)
+    {
+        my_condition_variable_broadcast(&self->wal->turn_condition_variable);
+    }
+    for (size_t i = 0; i < self->n_numa_nodes; i++)
+    {
+        mpsc_numa_node_t *node = &self->numa_nodes[i];
+        my_mutex_set_lock_state(&node->mutex, true);
+        node->closed = true;
+        my_condition_variable_broadcast(&node->not_full_condition_variable);
+        my_mutex_set_lock_state(&node->mutex, false);
+    }
+    mpsc_producer_t *producer = self->wait_queue_head;
+    while (producer != NULL)
+    {
+        mpsc_producer_t *next = producer->wait_next;
+        producer->wait_next = NULL;
+        my_condition_variable_signal(&producer->condition_variable);
+        producer = next;
+    }
+    self->wait_queue_head = NULL;
+    self->wait_queue_tail = NULL;
+    self->n_producers_waiting = 0;
+    self->next_waiting_producer = NULL;
+    mpsc_notify_select_producers(self);
+}
+
+static void mpsc_waiter_init(mpsc_waiter_t *self)
+{
+    my_mutex_init(&self->mutex, false);
+    my_condition_variable_init(&self->condition_variable, false);
+    self->notified = false;
+}
+
+static void mpsc_waiter_destroy(mpsc_waiter_t *self)
+{
+    my_condition_variable_destroy(&self->condition_variable);
+    my_mutex_destroy(&self->mutex);
+}
+
+static void mpsc_waiter_notify(mpsc_waiter_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    self->notified = true;
+    my_condition_variable_signal(&self->condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+}
+
+static bool mpsc_waiter_wait(mpsc_waiter_t *self, const struct timespec *deadline)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    while (!self->notified)
+    {
+        if (deadline == NULL)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+        }
+        else if (!my_condition_variable_timed_wait(&self->condition_variable, &self->mutex, deadline))
+        {
+            break;
+        }
+    }
+    bool notified = self->notified;
+    my_mutex_set_lock_state(&self->mutex, false);
+    return notified;
+}
+
+static void mpsc_producer_done(mpsc_producer_t *self)
+{
+    my_mutex_set_lock_state(&self->mpsc->mutex, true);
+    if (!self->done)
+    {
+        self->done = true;
+        self->mpsc->n_producers_closed += 1;
+        self->slot_next = self->mpsc->finished_producers;
+        self->mpsc->finished_producers = self;
+        if (
+            self->mpsc->n_producers_closed == self->mpsc->producer_count &&
+            self->mpsc->sealed)
+        {
+            mpsc_mark_closed(self->mpsc);
+        }
+    }
+    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+}
+
+void *mpsc_producer_context(mpsc_producer_t *self)
+{
+    return self->application_context;
+}
+
+mpsc_register_producer_error_t mpsc_producer_register_producer(mpsc_producer_t *self, mpsc_producer_thread_callback_t callback, void *context)
+{
+    return mpsc_register_producer(self->mpsc, callback, context);
+}
+
+static void mpsc_producer_subscribe_to_wait_queue(mpsc_producer_t *self)
+{
+    mpsc_t *mpsc = self->mpsc;
+    if (self->wait_next != NULL || mpsc->wait_queue_tail == self)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] producer 'id = %zu' (%p) has already subscribed to waiting list\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, self->id, (void *)self);
+        abort();
+    }
+    if (mpsc->wait_queue_tail == NULL)
+    {
+        mpsc->wait_queue_head = self;
+    }
+    else
+    {
+        mpsc->wait_queue_tail->wait_next = self;
+    }
+    mpsc->wait_queue_tail = self;
+    mpsc->n_producers_waiting += 1;
+    mpsc_record_queue_depth(mpsc);
+    MPSC_PROBE(wait_subscribe, mpsc, self->id, mpsc->n_producers_waiting);
+}
+
+static void mpsc_reap_finished_producers(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held. A finished producer's thread has
+    // already released the lock for the last time (see `mpsc_producer_done`), so
+    // joining it here can only wait for the thread to return. Reaping doesn't
+    // change whether `producer_count == n_producers_closed`.
+    while (self->finished_producers != NULL)
+    {
+        mpsc_producer_t *producer = self->finished_producers;
+        self->finished_producers = producer->slot_next;
+        if (producer->threaded)
+        {
+            my_thread_wait(&producer->thread);
+        }
+        producer->in_use = false;
+        producer->slot_next = self->free_producer_slots;
+        self->free_producer_slots = producer;
+        self->producer_count -= 1;
+        self->n_producers_closed -= 1;
+    }
+}
+
+static void mpsc_shift_producer_wait_queue(mpsc_t *self)
+{
+    if (self->wait_queue_head == NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] empty queue\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    mpsc_producer_t *producer = self->wait_queue_head;
+    self->wait_queue_head = producer->wait_next;
+    if (self->wait_queue_head == NULL)
+    {
+        self->wait_queue_tail = NULL;
+    }
+    producer->wait_next = NULL;
+    self->n_producers_waiting -= 1;
+    self->next_waiting_producer = NULL;
+}
+
+static mpsc_producer_t *mpsc_producer_slot(mpsc_t *self, size_t id)
+{
+    if (self->producer_storage != NULL)
+    {
+        return &self->producer_storage[id];
+    }
+    return &self->producer_chunks[id / MPSC_PRODUCER_CHUNK_SIZE][id % MPSC_PRODUCER_CHUNK_SIZE];
+}
+
+static size_t mpsc_producer_chunk_length(mpsc_t *self, size_t chunk_index)
+{
+    // NOTE: The last chunk is trimmed, so that no more than `n_max_producers`
+    // producers are ever allocated.
+    size_t remaining = self->n_max_producers - chunk_index * MPSC_PRODUCER_CHUNK_SIZE;
+    return remaining < MPSC_PRODUCER_CHUNK_SIZE ? remaining : MPSC_PRODUCER_CHUNK_SIZE;
+}
+
+static mpsc_register_producer_error_t mpsc_producer_chunk_create(mpsc_t *self, size_t chunk_index)
+{
+    // NOTE: Must be called with the lock held.
+    size_t length = mpsc_producer_chunk_length(self, chunk_index);
+    mpsc_producer_t *chunk;
+    if (self->storage_provided)
+    {
+        // NOTE: The slots already exist, so only their condition variables
+        // need to be initialized.
+        chunk = &self->producer_storage[chunk_index * MPSC_PRODUCER_CHUNK_SIZE];
+    }
+    else
+    {
+        chunk = my_malloc(sizeof(mpsc_producer_t) * length, self->error_handling_enabled);
+        if (chunk == NULL)
+        {
+            return MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+        }
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        bool initialized = mpsc_condition_variable_init(self, &chunk[i].condition_variable);
+        chunk[i].send_histogram = NULL;
+        if (
+            initialized &&
+            self->latency_histograms_enabled)
+        {
+            chunk[i].send_histogram = mpsc_histogram_create(self);
+            if (chunk[i].send_histogram == NULL)
+            {
+                my_condition_variable_destroy(&chunk[i].condition_variable);
+                initialized = false;
+            }
+        }
+        if (!initialized)
+        {
+            int custom_errno = errno;
+            for (size_t j = 0; j < i; j++)
+            {
+                my_condition_variable_destroy(&chunk[j].condition_variable);
+                my_free(chunk[j].send_histogram);
+            }
+            if (!self->storage_provided)
+            {
+                my_free(chunk);
+            }
+            errno = custom_errno;
+            return custom_errno == EAGAIN ? MPSC_REGISTER_PRODUCER_ERROR_EAGAIN : MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+        }
+        chunk[i].id = chunk_index * MPSC_PRODUCER_CHUNK_SIZE + i;
+        chunk[i].in_use = false;
+        chunk[i].counters = (mpsc_producer_counters_t){0};
+        chunk[i].tracing = 0;
+    }
+    if (!self->storage_provided)
+    {
+        self->producer_chunks[chunk_index] = chunk;
+    }
+    return MPSC_REGISTER_PRODUCER_ERROR_NONE;
+}
+
+static void mpsc_destroy_resources(mpsc_t *self)
+{
+    if (self->fd_poller != NULL)
+    {
+        // NOTE: The thread has detached its producer, which it does right before returning.
+        mpsc_fd_poller_destroy(self->fd_poller);
+    }
+    if (self->executor != NULL)
+    {
+        my_mutex_set_lock_state(&self->executor->mutex, true);
+        self->executor->n_channels -= 1;
+        my_mutex_set_lock_state(&self->executor->mutex, false);
+    }
+    if (self->dispatch_workers != NULL)
+    {
+        mpsc_dispatch_destroy(self);
+    }
+    if (self->numa_nodes != NULL)
+    {
+        mpsc_numa_destroy(self);
+    }
+    if (self->spill != NULL)
+    {
+        mpsc_spill_destroy(self);
+    }
+    if (self->wal != NULL)
+    {
+        mpsc_wal_destroy(self);
+    }
+    my_mutex_destroy(&self->mutex);
+    my_condition_variable_destroy(&self->condition_variable);
+    if (self->reusable)
+    {
+        my_condition_variable_destroy(&self->idle_condition_variable);
+    }
+    my_free(self->delivery_counters.histograms);
+    size_t n_producer_chunks = (self->n_producer_slots + MPSC_PRODUCER_CHUNK_SIZE - 1) / MPSC_PRODUCER_CHUNK_SIZE;
+    for (size_t i = 0; i < n_producer_chunks; i++)
+    {
+        size_t length = mpsc_producer_chunk_length(self, i);
+        for (size_t j = 0; j < length; j++)
+        {
+            mpsc_producer_t *producer = mpsc_producer_slot(self, i * MPSC_PRODUCER_CHUNK_SIZE + j);
+            my_condition_variable_destroy(&producer->condition_variable);
+            my_free(producer->send_histogram);
+        }
+        if (!self->storage_provided)
+        {
+            my_free(self->producer_chunks[i]);
+        }
+    }
+    if (self->mapped_storage_size > 0)
+    {
+        // NOTE: Unmapping also unlocks the memory.
+        munmap(self, self->mapped_storage_size);
+        return;
+    }
+    if (self->storage_provided)
+    {
+        return;
+    }
+    my_free(self->producer_chunks);
+    my_huge_pages_free(self->buffer, self->buffer_mapped_size);
+    my_free(self);
+}
+
+static void *mpsc_handle_creation_failure(mpsc_t *self, mpsc_handle_creation_failure_type_t type)
+{
+    // NOTE: No producer chunk can have been allocated yet, since producers can
+    // only be registered once `mpsc_create` has returned.
+    int custom_errno;
+    switch (errno)
+    {
+    case ENOMEM:
+        custom_errno = ENOMEM;
+        break;
+    case EAGAIN:
+        custom_errno = EAGAIN;
+        break;
+    case EPERM:
+        custom_errno = EPERM;
+        break;
+    default:
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'errno = %i' no supported by this call\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, errno);
+        abort();
+    }
+    switch (type)
+    {
+    case MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE:
+        if (self->dispatch_workers != NULL)
+        {
+            mpsc_dispatch_shutdown(self);
+            mpsc_dispatch_destroy(self);
+        }
+        if (self->numa_nodes != NULL)
+        {
+            mpsc_numa_destroy(self);
+        }
+        if (self->spill != NULL)
+        {
+            mpsc_spill_destroy(self);
+        }
+        if (self->wal != NULL)
+        {
+            mpsc_wal_destroy(self);
+        }
+        my_mutex_destroy(&self->mutex);
+        my_condition_variable_destroy(&self->condition_variable);
+        if (self->reusable)
+        {
+            my_condition_variable_destroy(&self->idle_condition_variable);
+        }
+        break;
+    case MPSC_HANDLE_CREATION_FAILURE_IDLE_COND_VAR_INIT:
+        my_mutex_destroy(&self->mutex);
+        my_condition_variable_destroy(&self->condition_variable);
+        break;
+    case MPSC_HANDLE_CREATION_FAILURE_MUTEX_INIT:
+        my_condition_variable_destroy(&self->condition_variable);
+        break;
+    default:
+        break;
+    }
+    if (self != NULL)
+    {
+        my_free(self->delivery_counters.histograms);
+    }
+    if (
+        self != NULL &&
+        self->mapped_storage_size > 0)
+    {
+        munmap(self, self->mapped_storage_size);
+    }
+    else if (self != NULL && !self->storage_provided)
+    {
+        if (self->producer_chunks != NULL)
+        {
+            my_free(self->producer_chunks);
+        }
+        if (self->buffer != NULL)
+        {
+            my_huge_pages_free(self->buffer, self->buffer_mapped_size);
+        }
+        my_free(self);
+    }
+    errno = custom_errno;
+    return NULL;
+}
+
+static void *mpsc_mapped_storage_create(mpsc_create_params_t *params, size_t *storage_size)
+{
+    // NOTE: The channel uses the same layout as with `mpsc_init`, followed (in real-time mode)
+    // by the delivery buffer, so that all of its memory can be prefaulted and locked at once.
+    bool handle_errors = params->error_handling_enabled;
+    size_t size = MPSC_STORAGE_SIZE(params->buffer_size, params->n_max_producers);
+    void *storage;
+    if (params->process_shared)
+    {
+        // NOTE: The file descriptor isn't needed once mapped, since child processes inherit
+        // the mapping itself. The memfd only names it (e.g., in `/proc/<pid>/maps`), so other
+        // platforms use an anonymous shared mapping instead.
+#ifdef __linux__
+        storage = MAP_FAILED;
+        int fd = memfd_create("mpsc", MFD_CLOEXEC);
+        if (fd >= 0)
+        {
+            if (ftruncate(fd, (off_t)size) == 0)
+            {
+                storage = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            close(fd);
+        }
+#else
+        storage = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+#endif
+    }
+    else
+    {
+        size += params->buffer_size;
+        storage = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (storage == MAP_FAILED)
+    {
+        if (handle_errors)
+        {
+            errno = ENOMEM;
+            return NULL;
+        }
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to mmap failed with errno = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, errno);
+        abort();
+    }
+#ifdef MADV_HUGEPAGE
+    if (params->huge_pages_enabled)
+    {
+        // NOTE: Best effort, and must happen before the memory is faulted in below.
+        madvise(storage, size, MADV_HUGEPAGE);
+    }
+#endif
+    if (params->process_shared)
+    {
+        *storage_size = size;
+        return storage;
+    }
+    // NOTE: Writing to each page makes the kernel back it now, rather than on first use.
+    memset(storage, 0, size);
+    if (mlock(storage, size) != 0)
+    {
+        int reason_code = errno;
+        munmap(storage, size);
+        if (handle_errors)
+        {
+            errno = reason_code;
+            return NULL;
+        }
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to mlock failed with errno = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+    *storage_size = size;
+    return storage;
+}
+
+static bool mpsc_condition_variable_init(mpsc_t *self, pthread_cond_t *condition_variable)
+{
+    if (!self->process_shared)
+    {
+        return my_condition_variable_init(condition_variable, self->error_handling_enabled);
+    }
+    pthread_condattr_t attributes;
+    my_condition_variable_attributes_init(&attributes);
+    my_condition_variable_attributes_set_process_shared(&attributes);
+    bool ok = my_condition_variable_init_with_attributes(condition_variable, &attributes, self->error_handling_enabled);
+    pthread_condattr_destroy(&attributes);
+    return ok;
+}
+
+static void mpsc_create_params_validate(mpsc_create_params_t *params)
+{
+    my_thread_attributes_validate(&params->consumer_thread_attributes, "consumer_thread_attributes");
+    my_thread_attributes_validate(&params->producer_thread_attributes, "producer_thread_attributes");
+    if (
+        params->consumer_callback == NULL &&
+        !params->pull_mode_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'consumer_callback = NULL'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->error_handling_enabled &&
+        params->consumer_error_callback == NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'consumer_error_callback = NULL'; must be present when 'error_handling_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (params->n_max_producers == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'n_max_producers = 0'; requires at least 1\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->n_dispatch_workers > 0 &&
+        params->dispatch_queue_capacity == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'dispatch_queue_capacity = 0'; requires at least 1 when 'n_dispatch_workers > 0'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->numa_enabled &&
+        (params->pull_mode_enabled || params->executor != NULL || params->n_dispatch_workers > 0 || params->reusable))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'numa_enabled = true' can't be combined with 'pull_mode_enabled', 'executor', 'n_dispatch_workers' or 'reusable'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->realtime_enabled &&
+        (params->pull_mode_enabled || params->executor != NULL || params->n_dispatch_workers > 0 || params->numa_enabled))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'realtime_enabled = true' can't be combined with 'pull_mode_enabled', 'executor', 'n_dispatch_workers' or 'numa_enabled'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->process_shared &&
+        (params->pull_mode_enabled || params->executor != NULL || params->n_dispatch_workers > 0 || params->reusable ||
+         params->numa_enabled || params->realtime_enabled || params->huge_pages_enabled))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'process_shared = true' can't be combined with 'pull_mode_enabled', 'executor', 'n_dispatch_workers', 'reusable', 'numa_enabled', 'realtime_enabled' or 'huge_pages_enabled'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->busy_poll_enabled &&
+        (params->pull_mode_enabled || params->executor != NULL || params->numa_enabled))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'busy_poll_enabled = true' can't be combined with 'pull_mode_enabled', 'executor' or 'numa_enabled'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (params->busy_poll_idle_timeout_us < 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'busy_poll_idle_timeout_us = %li'; must be 0 or greater\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, params->busy_poll_idle_timeout_us);
+        abort();
+    }
+#if !defined(_POSIX_THREAD_PRIO_INHERIT) || _POSIX_THREAD_PRIO_INHERIT <= 0
+    if (params->realtime_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'realtime_enabled = true' requires priority inheritance mutexes, which aren't supported on this platform\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+#endif
+    if (
+        params->realtime_enabled &&
+        (params->realtime_priority < sched_get_priority_min(SCHED_FIFO) || params->realtime_priority > sched_get_priority_max(SCHED_FIFO)))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'realtime_priority = %i'; must be within [%i, %i]\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, params->realtime_priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+        abort();
+    }
+#ifndef __linux__
+    if (params->numa_enabled)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'numa_enabled = true' is only supported on Linux\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+#endif
+    if (
+        params->numa_enabled &&
+        params->numa_queue_capacity == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'numa_queue_capacity = 0'; requires at least 1 when 'numa_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->numa_enabled &&
+        params->numa_node_of_cpu != NULL &&
+        params->numa_n_nodes == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'numa_n_nodes = 0'; requires at least 1 when 'numa_node_of_cpu' is set\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->reusable &&
+        params->n_dispatch_workers > 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'reusable = true' requires 'n_dispatch_workers = 0'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->executor != NULL &&
+        (params->pull_mode_enabled || params->n_dispatch_workers > 0))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'executor' requires 'pull_mode_enabled = false' and 'n_dispatch_workers = 0'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->pull_mode_enabled &&
+        params->n_dispatch_workers > 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'n_dispatch_workers' must be 0 when 'pull_mode_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->spill_directory != NULL &&
+        (params->pull_mode_enabled || params->executor != NULL || params->reusable ||
+         params->numa_enabled || params->realtime_enabled || params->process_shared))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'spill_directory' can't be combined with 'pull_mode_enabled', 'executor', 'reusable', 'numa_enabled', 'realtime_enabled' or 'process_shared'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->wal_path != NULL &&
+        (params->pull_mode_enabled || params->executor != NULL || params->n_dispatch_workers > 0 || params->reusable ||
+         params->numa_enabled || params->realtime_enabled || params->process_shared || params->spill_directory != NULL))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'wal_path' can't be combined with 'pull_mode_enabled', 'executor', 'n_dispatch_workers', 'reusable', 'numa_enabled', 'realtime_enabled', 'process_shared' or 'spill_directory'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (
+        params->latency_histograms_enabled &&
+        params->process_shared)
+    {
+        // NOTE: The histograms are allocated on the heap, which isn't shared with child processes.
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'latency_histograms_enabled' can't be combined with 'process_shared'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    size_t spill_segment_size = params->spill_segment_size == 0 ? MPSC_SPILL_SEGMENT_SIZE : params->spill_segment_size;
+    if (
+        params->spill_directory != NULL &&
+        spill_segment_size < MPSC_SPILL_RECORD_SIZE(params->buffer_size))
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'spill_segment_size = %zu'; requires at least %zu for 'buffer_size = %zu'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, spill_segment_size, MPSC_SPILL_RECORD_SIZE(params->buffer_size), params->buffer_size);
+        abort();
+    }
+}
+
+static void *my_producer_thread_callback(void *context)
+{
+    mpsc_producer_t *producer = (mpsc_producer_t *)context;
+    (producer->callback)(producer);
+    mpsc_producer_done(producer);
+    return NULL;
+}
+
+static void *my_consumer_thread_callback(void *context)
+{
+    mpsc_t *mpsc = (mpsc_t *)context;
+    pthread_mutex_t *mutex = &mpsc->mutex;
+    pthread_cond_t *condition_variable = &mpsc->condition_variable;
+    mpsc_consumer_callback_t *callback = mpsc->consumer_callback;
+    mpsc_consumer_error_callback_t *error_callback = mpsc->consumer_error_callback;
+    if (mpsc->numa_nodes != NULL)
+    {
+        mpsc_numa_consume(mpsc);
+        // IMPORTANT: don't hold the lock while calling the callback!
+        (callback)(&mpsc->consumer, NULL, 0, true);
+        return NULL;
+    }
+    if (mpsc->wal != NULL)
+    {
+        mpsc_wal_replay(mpsc);
+    }
+    while (true)
+    {
+        my_mutex_set_lock_state(mutex, true);
+        // NOTE: A signaled producer (i.e., `next_waiting_producer`) owns the internal buffer
+        // even while it's empty, and its message is older than the spilled ones, so the spill
+        // is only read from once that producer has written its message.
+        while (
+            !mpsc->pending_message &&
+            (mpsc_spill_is_empty(mpsc) || mpsc->next_waiting_producer != NULL) &&
+            !mpsc->closed)
+        {
+            if (mpsc->busy_poll_enabled)
+            {
+                mpsc_consumer_busy_poll(mpsc);
+            }
+            else
+            {
+                my_condition_variable_wait(condition_variable, mutex);
+                MPSC_PROBE(consumer_wake, mpsc, (int)mpsc->pending_message);
+            }
+            mpsc->n_consumer_wakeups += 1;
+        }
+        if (
+            mpsc->closed &&
+            !mpsc->pending_message && // NEW: If we have a pending message, we deliver it first
+            mpsc_spill_is_empty(mpsc))
+        {
+            if (!mpsc->reusable)
+            {
+                my_mutex_set_lock_state(mutex, false);
+                break;
+            }
+            // NOTE: A reusable channel's consumer thread delivers the "closed" call,
+            // and then parks until the channel is either reset or destroyed.
+            size_t reset_count = mpsc->reset_count;
+            my_mutex_set_lock_state(mutex, false);
+            (callback)(&mpsc->consumer, NULL, 0, true);
+            my_mutex_set_lock_state(mutex, true);
+            mpsc->consumer_finished = true;
+            my_condition_variable_broadcast(&mpsc->idle_condition_variable);
+            while (
+                mpsc->reset_count == reset_count &&
+                !mpsc->destroying)
+            {
+                my_condition_variable_wait(&mpsc->idle_condition_variable, mutex);
+            }
+            bool destroying = mpsc->destroying;
+            my_mutex_set_lock_state(mutex, false);
+            if (destroying)
+            {
+                return NULL;
+            }
+            continue;
+        }
+        if (mpsc->downstream_producer != NULL)
+        {
+            my_mutex_set_lock_state(mutex, false);
+            mpsc_forward_pending_message(mpsc);
+            continue;
+        }
+        uint64_t key = mpsc->key;
+        uint64_t enqueue_ns = mpsc->enqueue_ns;
+        void *buffer;
+        size_t n;
+        if (!mpsc->pending_message)
+        {
+            // NOTE: The spill is only read from once the internal buffer is empty, and no
+            // producer has been signaled to fill it (or the channel has been closed, in
+            // which case that producer gives up), since both hold older messages than
+            // the spilled ones.
+            bool copied = mpsc_spill_pop(mpsc, &key, &buffer, &n, &enqueue_ns);
+            my_mutex_set_lock_state(mutex, false);
+            if (!copied)
+            {
+                // IMPORTANT: don't hold the lock while calling the callback!
+                (error_callback)(&mpsc->consumer);
+                continue;
+            }
+        }
+        else if (!mpsc_consumer_copy_message(mpsc, &buffer, &n))
+        {
+            mpsc_release_buffer(mpsc);
+            my_mutex_set_lock_state(mutex, false);
+            // IMPORTANT: don't hold the lock while calling the callback!
+            (error_callback)(&mpsc->consumer);
+            continue;
+        }
+        else
+        {
+            if (mpsc->wal != NULL)
+            {
+                mpsc->wal->delivered_sequence = mpsc->wal->pending_sequence;
+            }
+            mpsc_release_buffer(mpsc);
+            my_mutex_set_lock_state(mutex, false);
+        }
+        if (mpsc->dispatch_workers != NULL)
+        {
+            // NOTE: This blocks while the worker's queue is full, in which case the
+            // next message stays in the internal buffer and producers have to wait.
+            mpsc_dispatch_push(&mpsc->dispatch_workers[key % mpsc->n_dispatch_workers], buffer, n, enqueue_ns);
+            continue;
+        }
+        // IMPORTANT: don't hold the lock while calling the callback!
+        mpsc_consumer_deliver(mpsc, &mpsc->delivery_counters, buffer, n, enqueue_ns);
+    }
+    if (mpsc->downstream_producer != NULL)
+    {
+        mpsc_producer_done(mpsc->downstream_producer);
+    }
+    if (mpsc->dispatch_workers != NULL)
+    {
+        // NOTE: Workers deliver whatever is left in their queue before returning,
+        // so that the "closed" call below is always the last one.
+        mpsc_dispatch_shutdown(mpsc);
+    }
+    // IMPORTANT: don't hold the lock while calling the callback!
+    (callback)(&mpsc->consumer, NULL, 0, true);
+    return NULL;
+}
+
+static void mpsc_consumer_busy_poll(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held, which is released while spinning,
+    // and held again on return (i.e., this is used like a condition variable wait,
+    // including spurious wake-ups).
+    uint64_t notifications = self->consumer_notifications;
+    my_mutex_set_lock_state(&self->mutex, false);
+    long timeout_us = self->busy_poll_idle_timeout_us;
+    struct timespec start;
+    if (timeout_us > 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    size_t iterations = 0;
+    while (__atomic_load_n(&self->consumer_notifications, __ATOMIC_ACQUIRE) == notifications)
+    {
+        my_cpu_relax();
+        iterations += 1;
+        if (
+            timeout_us == 0 ||
+            iterations % MPSC_BUSY_POLL_CLOCK_INTERVAL != 0)
+        {
+            continue;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed_us = (now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000L;
+        if (elapsed_us < timeout_us)
+        {
+            continue;
+        }
+        // NOTE: Producers only signal the consumer thread once it's marked as parked,
+        // which happens with the lock held, after checking that nothing was missed.
+        my_mutex_set_lock_state(&self->mutex, true);
+        if (self->consumer_notifications == notifications)
+        {
+            self->consumer_parked = true;
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+            self->consumer_parked = false;
+            MPSC_PROBE(consumer_wake, self, (int)self->pending_message);
+        }
+        return;
+    }
+    my_mutex_set_lock_state(&self->mutex, true);
+}
+
+static void mpsc_forward_pending_message(mpsc_t *self)
+{
+    // NOTE: While `pending_message = true`, no producer can write to the internal
+    // buffer, so it can be transformed and copied without holding the lock. Producers
+    // that try to send in the meantime wait in the queue, as they would if the
+    // consumer callback was still running, which is how the downstream channel's
+    // backpressure reaches this channel's producers.
+    size_t n = self->n;
+    bool forward = true;
+    if (self->transform_callback != NULL)
+    {
+        forward = (self->transform_callback)(self->buffer, &n, self->buffer_size, self->transform_context);
+    }
+    bool accepted = true;
+    if (forward)
+    {
+        accepted = mpsc_producer_send_keyed(self->downstream_producer, self->key, n > 0 ? self->buffer : NULL, n);
+    }
+    my_mutex_set_lock_state(&self->mutex, true);
+    mpsc_release_buffer(self);
+    my_mutex_set_lock_state(&self->mutex, false);
+    if (!accepted)
+    {
+        // NOTE: The downstream channel has been closed, so there is no point
+        // in accepting more messages on this one.
+        mpsc_consumer_close(&self->consumer);
+    }
+}
+
+static bool mpsc_dispatch_create(mpsc_t *self)
+{
+    bool handle_errors = self->error_handling_enabled;
+    mpsc_dispatch_worker_t *workers = my_malloc(sizeof(mpsc_dispatch_worker_t) * self->n_dispatch_workers, handle_errors);
+    if (workers == NULL)
+    {
+        return false;
+    }
+    size_t i = 0;
+    for (; i < self->n_dispatch_workers; i++)
+    {
+        mpsc_dispatch_worker_t *worker = &workers[i];
+        worker->mpsc = self;
+        worker->head = 0;
+        worker->count = 0;
+        worker->closed = false;
+        worker->counters = (mpsc_delivery_counters_t){0};
+        worker->entries = my_malloc(sizeof(mpsc_dispatch_entry_t) * self->dispatch_queue_capacity, handle_errors);
+        if (worker->entries == NULL)
+        {
+            break;
+        }
+        if (self->latency_histograms_enabled)
+        {
+            worker->counters.histograms = mpsc_consumer_histograms_create(self);
+            if (worker->counters.histograms == NULL)
+            {
+                my_free(worker->entries);
+                break;
+            }
+        }
+        if (!my_mutex_init(&worker->mutex, handle_errors))
+        {
+            my_free(worker->counters.histograms);
+            my_free(worker->entries);
+            break;
+        }
+        if (!my_condition_variable_init(&worker->not_empty_condition_variable, handle_errors))
+        {
+            my_mutex_destroy(&worker->mutex);
+            my_free(worker->counters.histograms);
+            my_free(worker->entries);
+            break;
+        }
+        if (!my_condition_variable_init(&worker->not_full_condition_variable, handle_errors))
+        {
+            my_condition_variable_destroy(&worker->not_empty_condition_variable);
+            my_mutex_destroy(&worker->mutex);
+            my_free(worker->counters.histograms);
+            my_free(worker->entries);
+            break;
+        }
+        if (!my_thread_create(&worker->thread_id, my_dispatch_worker_thread_callback, worker, handle_errors))
+        {
+            my_condition_variable_destroy(&worker->not_full_condition_variable);
+            my_condition_variable_destroy(&worker->not_empty_condition_variable);
+            my_mutex_destroy(&worker->mutex);
+            my_free(worker->counters.histograms);
+            my_free(worker->entries);
+            break;
+        }
+    }
+    self->dispatch_workers = workers;
+    if (i < self->n_dispatch_workers)
+    {
+        // NOTE: Only the first `i` workers were fully initialized, so we temporarily
+        // pretend that these are the only ones while tearing them down.
+        int custom_errno = errno;
+        size_t n_dispatch_workers = self->n_dispatch_workers;
+        self->n_dispatch_workers = i;
+        mpsc_dispatch_shutdown(self);
+        mpsc_dispatch_destroy(self);
+        self->n_dispatch_workers = n_dispatch_workers;
+        errno = custom_errno;
+        return false;
+    }
+    return true;
+}
+
+static void mpsc_dispatch_shutdown(mpsc_t *self)
+{
+    for (size_t i = 0; i < self->n_dispatch_workers; i++)
+    {
+        mpsc_dispatch_worker_t *worker = &self->dispatch_workers[i];
+        my_mutex_set_lock_state(&worker->mutex, true);
+        worker->closed = true;
+        my_condition_variable_signal(&worker->not_empty_condition_variable);
+        my_mutex_set_lock_state(&worker->mutex, false);
+    }
+    for (size_t i = 0; i < self->n_dispatch_workers; i++)
+    {
+        my_thread_join(self->dispatch_workers[i].thread_id);
+    }
+}
+
+static bool mpsc_numa_create(mpsc_t *self, mpsc_create_params_t *params)
+{
+    bool handle_errors = self->error_handling_enabled;
+    size_t n_nodes = params->numa_n_nodes;
+#ifdef __linux__
+    cpu_set_t node_cpus[CPU_SETSIZE / 64];
+    if (self->numa_node_of_cpu == NULL)
+    {
+        // NOTE: Each node lists its CPUs in a file such as "/sys/devices/system/node/node0/cpulist",
+        // using ranges (e.g., "0-3,8-11"). If none can be read, a single node is assumed.
+        n_nodes = 0;
+        while (n_nodes < sizeof(node_cpus) / sizeof(node_cpus[0]))
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", n_nodes);
+            FILE *file = fopen(path, "r");
+            if (file == NULL)
+            {
+                break;
+            }
+            CPU_ZERO(&node_cpus[n_nodes]);
+            int first;
+            while (fscanf(file, "%d", &first) == 1)
+            {
+                int last = first;
+                int separator = fgetc(file);
+                if (separator == '-')
+                {
+                    if (fscanf(file, "%d", &last) != 1)
+                    {
+                        break;
+                    }
+                    separator = fgetc(file);
+                }
+                for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+                {
+                    CPU_SET(cpu, &node_cpus[n_nodes]);
+                }
+                if (separator != ',')
+                {
+                    break;
+                }
+            }
+            fclose(file);
+            n_nodes += 1;
+        }
+        if (n_nodes == 0)
+        {
+            n_nodes = 1;
+            CPU_ZERO(&node_cpus[0]);
+        }
+    }
+#endif
+    mpsc_numa_node_t *nodes = my_malloc(sizeof(mpsc_numa_node_t) * n_nodes, handle_errors);
+    if (nodes == NULL)
+    {
+        return false;
+    }
+    size_t capacity = self->numa_queue_capacity;
+    size_t entries_size = capacity * (self->buffer_size > 0 ? self->buffer_size : 1);
+    size_t i = 0;
+    for (; i < n_nodes; i++)
+    {
+        mpsc_numa_node_t *node = &nodes[i];
+#ifdef __linux__
+        if (self->numa_node_of_cpu == NULL)
+        {
+            node->cpus = node_cpus[i];
+        }
+#endif
+        node->head = 0;
+        node->count = 0;
+        node->touched = false;
+        node->closed = false;
+        // NOTE: Memory from `my_malloc` might come from pages that were already touched
+        // (and placed) by another thread, while fresh anonymous mappings are only placed
+        // once written to (see `mpsc_numa_send`).
+        node->entries = my_pages_alloc(entries_size, handle_errors);
+        node->sizes = my_pages_alloc(sizeof(size_t) * capacity, handle_errors);
+        node->drained = my_malloc(sizeof(void *) * capacity, handle_errors);
+        node->drained_sizes = my_malloc(sizeof(size_t) * capacity, handle_errors);
+        if (
+            node->entries == NULL ||
+            node->sizes == NULL ||
+            node->drained == NULL ||
+            node->drained_sizes == NULL)
+        {
+            my_pages_free(node->entries, entries_size);
+            my_pages_free(node->sizes, sizeof(size_t) * capacity);
+            my_free(node->drained);
+            my_free(node->drained_sizes);
+            break;
+        }
+        if (!my_mutex_init(&node->mutex, handle_errors))
+        {
+            my_pages_free(node->entries, entries_size);
+            my_pages_free(node->sizes, sizeof(size_t) * capacity);
+            my_free(node->drained);
+            my_free(node->drained_sizes);
+            break;
+        }
+        if (!my_condition_variable_init(&node->not_full_condition_variable, handle_errors))
+        {
+            my_mutex_destroy(&node->mutex);
+            my_pages_free(node->entries, entries_size);
+            my_pages_free(node->sizes, sizeof(size_t) * capacity);
+            my_free(node->drained);
+            my_free(node->drained_sizes);
+            break;
+        }
+    }
+    self->numa_nodes = nodes;
+    self->n_numa_nodes = i;
+    if (i < n_nodes)
+    {
+        int custom_errno = errno;
+        mpsc_numa_destroy(self);
+        errno = custom_errno;
+        return false;
+    }
+    return true;
+}
+
+static void mpsc_numa_destroy(mpsc_t *self)
+{
+    size_t capacity = self->numa_queue_capacity;
+    size_t entries_size = capacity * (self->buffer_size > 0 ? self->buffer_size : 1);
+    for (size_t i = 0; i < self->n_numa_nodes; i++)
+    {
+        mpsc_numa_node_t *node = &self->numa_nodes[i];
+        my_condition_variable_destroy(&node->not_full_condition_variable);
+        my_mutex_destroy(&node->mutex);
+        my_pages_free(node->entries, entries_size);
+        my_pages_free(node->sizes, sizeof(size_t) * capacity);
+        my_free(node->drained);
+        my_free(node->drained_sizes);
+    }
+    my_free(self->numa_nodes);
+    self->numa_nodes = NULL;
+    self->n_numa_nodes = 0;
+}
+
+static size_t mpsc_numa_current_node(mpsc_t *self)
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+#else
+    // NOTE: Unreachable, since NUMA mode is rejected on other platforms.
+    int cpu = -1;
+#endif
+    if (self->numa_node_of_cpu != NULL)
+    {
+        int node = (self->numa_node_of_cpu)(cpu, self->numa_context);
+        if (
+            node < 0 ||
+            (size_t)node >= self->n_numa_nodes)
+        {
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] 'numa_node_of_cpu' returned invalid node '%i' for CPU '%i'\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__, node, cpu);
+            abort();
+        }
+        return (size_t)node;
+    }
+#ifdef __linux__
+    for (size_t i = 0; cpu >= 0 && i < self->n_numa_nodes; i++)
+    {
+        if (CPU_ISSET(cpu, &self->numa_nodes[i].cpus))
+        {
+            return i;
+        }
+    }
+#endif
+    return 0;
+}
+
+static bool mpsc_numa_send(mpsc_producer_t *self, void *data, size_t n)
+{
+    mpsc_t *mpsc = self->mpsc;
+    if (self->numa_node < 0)
+    {
+        self->numa_node = (ssize_t)mpsc_numa_current_node(mpsc);
+    }
+    mpsc_numa_node_t *node = &mpsc->numa_nodes[self->numa_node];
+    size_t capacity = mpsc->numa_queue_capacity;
+    my_mutex_set_lock_state(&node->mutex, true);
+    if (!node->touched)
+    {
+        memset(node->entries, 0, capacity * (mpsc->buffer_size > 0 ? mpsc->buffer_size : 1));
+        memset(node->sizes, 0, sizeof(size_t) * capacity);
+        node->touched = true;
+    }
+    while (
+        !node->closed &&
+        node->count == capacity)
+    {
+        my_condition_variable_wait(&node->not_full_condition_variable, &node->mutex);
+    }
+    if (node->closed)
+    {
+        my_mutex_set_lock_state(&node->mutex, false);
+        return false;
+    }
+    size_t index = (node->head + node->count) % capacity;
+    if (n > 0)
+    {
+        memcpy(node->entries + index * mpsc->buffer_size, data, n);
+    }
+    node->sizes[index] = n;
+    node->count += 1;
+    // NOTE: The consumer thread empties a sub-queue every time it drains it, so
+    // only the producer that makes it non-empty needs to wake the consumer up.
+    bool was_empty = node->count == 1;
+    my_mutex_set_lock_state(&node->mutex, false);
+    if (was_empty)
+    {
+        my_mutex_set_lock_state(&mpsc->mutex, true);
+        mpsc->numa_pending = true;
+        mpsc_notify_consumer(mpsc);
+        my_mutex_set_lock_state(&mpsc->mutex, false);
+    }
+    return true;
+}
+
+static void mpsc_numa_consume(mpsc_t *self)
+{
+    while (true)
+    {
+        my_mutex_set_lock_state(&self->mutex, true);
+        while (
+            !self->numa_pending &&
+            !self->closed)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+            self->n_consumer_wakeups += 1;
+            MPSC_PROBE(consumer_wake, self, (int)self->numa_pending);
+        }
+        // NOTE: `numa_pending` is cleared before draining, so that a sub-queue that
+        // becomes non-empty while draining sets it again. Once closed, producers can't
+        // add to the sub-queues, so the drain below is the last one.
+        self->numa_pending = false;
+        bool closed = self->closed;
+        my_mutex_set_lock_state(&self->mutex, false);
+        for (size_t i = 0; i < self->n_numa_nodes; i++)
+        {
+            mpsc_numa_drain(self, &self->numa_nodes[i]);
+        }
+        if (closed)
+        {
+            return;
+        }
+    }
+}
+
+static void mpsc_numa_drain(mpsc_t *self, mpsc_numa_node_t *node)
+{
+    size_t capacity = self->numa_queue_capacity;
+    my_mutex_set_lock_state(&node->mutex, true);
+    size_t count = node->count;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t index = (node->head + i) % capacity;
+        size_t n = node->sizes[index];
+        void *buffer = NULL;
+        if (n > 0)
+        {
+            buffer = my_malloc(n, self->error_handling_enabled);
+            if (buffer == NULL)
+            {
+                // NOTE: Reported (and the message dropped) once the lock is released.
+                node->drained_sizes[i] = SIZE_MAX;
+                continue;
+            }
+            memcpy(buffer, node->entries + index * self->buffer_size, n);
+        }
+        node->drained[i] = buffer;
+        node->drained_sizes[i] = n;
+    }
+    node->head = (node->head + count) % capacity;
+    node->count = 0;
+    if (count > 0)
+    {
+        my_condition_variable_broadcast(&node->not_full_condition_variable);
+    }
+    my_mutex_set_lock_state(&node->mutex, false);
+    // IMPORTANT: don't hold the lock while calling the callback!
+    for (size_t i = 0; i < count; i++)
+    {
+        if (node->drained_sizes[i] == SIZE_MAX)
+        {
+            (self->consumer_error_callback)(&self->consumer);
+            continue;
+        }
+        mpsc_consumer_deliver(self, &self->delivery_counters, node->drained[i], node->drained_sizes[i], 0);
+    }
+}
+
+static void mpsc_dispatch_destroy(mpsc_t *self)
+{
+    for (size_t i = 0; i < self->n_dispatch_workers; i++)
+    {
+        mpsc_dispatch_worker_t *worker = &self->dispatch_workers[i];
+        my_condition_variable_destroy(&worker->not_full_condition_variable);
+        my_condition_variable_destroy(&worker->not_empty_condition_variable);
+        my_mutex_destroy(&worker->mutex);
+        my_free(worker->counters.histograms);
+        my_free(worker->entries);
+    }
+    my_free(self->dispatch_workers);
+    self->dispatch_workers = NULL;
+}
+
+static void mpsc_dispatch_push(mpsc_dispatch_worker_t *worker, void *data, size_t n, uint64_t enqueue_ns)
+{
+    size_t capacity = worker->mpsc->dispatch_queue_capacity;
+    my_mutex_set_lock_state(&worker->mutex, true);
+    while (worker->count == capacity)
+    {
+        my_condition_variable_wait(&worker->not_full_condition_variable, &worker->mutex);
+    }
+    mpsc_dispatch_entry_t *entry = &worker->entries[(worker->head + worker->count) % capacity];
+    entry->data = data;
+    entry->n = n;
+    entry->enqueue_ns = enqueue_ns;
+    worker->count += 1;
+    my_condition_variable_signal(&worker->not_empty_condition_variable);
+    my_mutex_set_lock_state(&worker->mutex, false);
+}
+
+static void *my_dispatch_worker_thread_callback(void *context)
+{
+    mpsc_dispatch_worker_t *worker = (mpsc_dispatch_worker_t *)context;
+    mpsc_t *mpsc = worker->mpsc;
+    size_t capacity = mpsc->dispatch_queue_capacity;
+    while (true)
+    {
+        my_mutex_set_lock_state(&worker->mutex, true);
+        while (
+            worker->count == 0 &&
+            !worker->closed)
+        {
+            my_condition_variable_wait(&worker->not_empty_condition_variable, &worker->mutex);
+        }
+        if (worker->count == 0)
+        {
+            my_mutex_set_lock_state(&worker->mutex, false);
+            break;
+        }
+        mpsc_dispatch_entry_t entry = worker->entries[worker->head];
+        worker->head = (worker->head + 1) % capacity;
+        worker->count -= 1;
+        my_condition_variable_signal(&worker->not_full_condition_variable);
+        my_mutex_set_lock_state(&worker->mutex, false);
+        // IMPORTANT: don't hold the lock while calling the callback!
+        mpsc_consumer_deliver(mpsc, &worker->counters, entry.data, entry.n, entry.enqueue_ns);
+    }
+    return NULL;
+}
+
+mpsc_executor_t *mpsc_executor_create(mpsc_executor_create_params_t params)
+{
+    if (params.n_threads == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'n_threads = 0'; requires at least 1\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    bool handle_errors = params.error_handling_enabled;
+    mpsc_executor_t *self = my_malloc(sizeof(mpsc_executor_t), handle_errors);
+    if (self == NULL)
+    {
+        return NULL;
+    }
+    self->n_threads = 0;
+    self->n_channels = 0;
+    self->stopping = false;
+    self->run_queue_head = NULL;
+    self->run_queue_tail = NULL;
+    self->thread_ids = my_malloc(sizeof(pthread_t) * params.n_threads, handle_errors);
+    if (self->thread_ids == NULL)
+    {
+        my_free(self);
+        return NULL;
+    }
+    if (!my_mutex_init(&self->mutex, handle_errors))
+    {
+        my_free(self->thread_ids);
+        my_free(self);
+        return NULL;
+    }
+    if (!my_condition_variable_init(&self->condition_variable, handle_errors))
+    {
+        my_mutex_destroy(&self->mutex);
+        my_free(self->thread_ids);
+        my_free(self);
+        return NULL;
+    }
+    for (size_t i = 0; i < params.n_threads; i++)
+    {
+        if (!my_thread_create(&self->thread_ids[i], my_executor_thread_callback, self, handle_errors))
+        {
+            // NOTE: `mpsc_executor_destroy` only joins the `n_threads` threads
+            // that were successfully created.
+            int custom_errno = errno;
+            mpsc_executor_destroy(self);
+            errno = custom_errno;
+            return NULL;
+        }
+        self->n_threads += 1;
+    }
+    return self;
+}
+
+void mpsc_executor_destroy(mpsc_executor_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (self->n_channels > 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] '%zu' channel(s) still bound to the executor\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, self->n_channels);
+        abort();
+    }
+    self->stopping = true;
+    my_condition_variable_broadcast(&self->condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+    for (size_t i = 0; i < self->n_threads; i++)
+    {
+        my_thread_join(self->thread_ids[i]);
+    }
+    my_condition_variable_destroy(&self->condition_variable);
+    my_mutex_destroy(&self->mutex);
+    my_free(self->thread_ids);
+    my_free(self);
+}
+
+static void mpsc_executor_schedule(mpsc_executor_t *self, mpsc_t *mpsc)
+{
+    // NOTE: Called either with the channel's lock held (by `mpsc_notify_consumer`), or
+    // by an executor thread rescheduling a channel it still owns; the executor's lock
+    // is never held while acquiring a channel's lock, so there's no lock inversion.
+    my_mutex_set_lock_state(&self->mutex, true);
+    mpsc->executor_next = NULL;
+    if (self->run_queue_tail == NULL)
+    {
+        self->run_queue_head = mpsc;
+    }
+    else
+    {
+        self->run_queue_tail->executor_next = mpsc;
+    }
+    self->run_queue_tail = mpsc;
+    my_condition_variable_signal(&self->condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+}
+
+static void mpsc_executor_run(mpsc_executor_t *self, mpsc_t *mpsc)
+{
+    // NOTE: While `executor_scheduled = true`, only the executor thread that
+    // dequeued the channel can run this function for it, which is what keeps
+    // the calls to the consumer callback serialized.
+    for (size_t i = 0; i < MPSC_EXECUTOR_BATCH_SIZE; i++)
+    {
+        my_mutex_set_lock_state(&mpsc->mutex, true);
+        if (!mpsc->pending_message)
+        {
+            if (!mpsc->closed)
+            {
+                mpsc->executor_scheduled = false;
+                my_mutex_set_lock_state(&mpsc->mutex, false);
+                return;
+            }
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+            // IMPORTANT: don't hold the lock while calling the callback!
+            (mpsc->consumer_callback)(&mpsc->consumer, NULL, 0, true);
+            // NOTE: `mpsc_join` may destroy the channel as soon as the lock is
+            // released, so the channel must not be accessed after that.
+            my_mutex_set_lock_state(&mpsc->mutex, true);
+            mpsc->consumer_finished = true;
+            my_condition_variable_signal(&mpsc->condition_variable);
+            my_mutex_set_lock_state(&mpsc->mutex, false);
+            return;
+        }
+        void *buffer;
+        size_t n;
+        uint64_t enqueue_ns = mpsc->enqueue_ns;
+        bool copied = mpsc_consumer_copy_message(mpsc, &buffer, &n);
+        mpsc_release_buffer(mpsc);
+        my_mutex_set_lock_state(&mpsc->mutex, false);
+        // IMPORTANT: don't hold the lock while calling the callback!
+        if (copied)
+        {
+            mpsc_consumer_deliver(mpsc, &mpsc->delivery_counters, buffer, n, enqueue_ns);
+        }
+        else
+        {
+            (mpsc->consumer_error_callback)(&mpsc->consumer);
+        }
+    }
+    mpsc_executor_schedule(self, mpsc);
+}
+
+static void *my_executor_thread_callback(void *context)
+{
+    mpsc_executor_t *self = (mpsc_executor_t *)context;
+    while (true)
+    {
+        my_mutex_set_lock_state(&self->mutex, true);
+        while (
+            self->run_queue_head == NULL &&
+            !self->stopping)
+        {
+            my_condition_variable_wait(&self->condition_variable, &self->mutex);
+        }
+        if (self->run_queue_head == NULL)
+        {
+            my_mutex_set_lock_state(&self->mutex, false);
+            break;
+        }
+        mpsc_t *mpsc = self->run_queue_head;
+        self->run_queue_head = mpsc->executor_next;
+        if (self->run_queue_head == NULL)
+        {
+            self->run_queue_tail = NULL;
+        }
+        my_mutex_set_lock_state(&self->mutex, false);
+        mpsc_executor_run(self, mpsc);
+    }
+    return NULL;
+}
+
+mpsc_broadcast_t *mpsc_broadcast_create(mpsc_broadcast_create_params_t params)
+{
+    mpsc_broadcast_create_params_validate(&params);
+    bool handle_errors = params.error_handling_enabled;
+    mpsc_broadcast_t *self = my_malloc(sizeof(mpsc_broadcast_t), handle_errors);
+    if (self == NULL)
+    {
+        return NULL;
+    }
+    self->buffer_size = params.buffer_size;
+    self->capacity = params.capacity;
+    self->n_max_subscribers = params.n_max_subscribers;
+    self->write_sequence = 0;
+    self->n_subscribers = 0;
+    self->closed = false;
+    self->buffer_mapped_size = 0;
+    if (params.huge_pages_enabled)
+    {
+        self->buffer = my_huge_pages_alloc(params.buffer_size * params.capacity, &self->buffer_mapped_size, handle_errors);
+    }
+    else
+    {
+        self->buffer = my_malloc(params.buffer_size * params.capacity, handle_errors);
+    }
+    self->sizes = self->buffer == NULL ? NULL : my_malloc(sizeof(size_t) * params.capacity, handle_errors);
+    self->subscribers = self->sizes == NULL ? NULL : my_malloc(sizeof(mpsc_broadcast_subscriber_t) * params.n_max_subscribers, handle_errors);
+    if (self->subscribers == NULL)
+    {
+        my_free(self->sizes);
+        my_huge_pages_free(self->buffer, self->buffer_mapped_size);
+        my_free(self);
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (size_t i = 0; i < params.n_max_subscribers; i++)
+    {
+        self->subscribers[i].broadcast = self;
+        self->subscribers[i].subscribed = false;
+    }
+    bool ok = my_mutex_init(&self->mutex, handle_errors);
+    if (ok && !my_condition_variable_init(&self->not_empty_condition_variable, handle_errors))
+    {
+        my_mutex_destroy(&self->mutex);
+        ok = false;
+    }
+    if (ok && !my_condition_variable_init(&self->not_full_condition_variable, handle_errors))
+    {
+        my_condition_variable_destroy(&self->not_empty_condition_variable);
+        my_mutex_destroy(&self->mutex);
+        ok = false;
+    }
+    if (!ok)
+    {
+        int custom_errno = errno;
+        my_free(self->subscribers);
+        my_free(self->sizes);
+        my_huge_pages_free(self->buffer, self->buffer_mapped_size);
+        my_free(self);
+        errno = custom_errno;
+        return NULL;
+    }
+    return self;
+}
+
+void mpsc_broadcast_destroy(mpsc_broadcast_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (self->n_subscribers > 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] '%zu' subscriber(s) still subscribed\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, self->n_subscribers);
+        abort();
+    }
+    my_mutex_set_lock_state(&self->mutex, false);
+    my_condition_variable_destroy(&self->not_full_condition_variable);
+    my_condition_variable_destroy(&self->not_empty_condition_variable);
+    my_mutex_destroy(&self->mutex);
+    my_free(self->subscribers);
+    my_free(self->sizes);
+    my_huge_pages_free(self->buffer, self->buffer_mapped_size);
+    my_free(self);
+}
+
+mpsc_broadcast_subscriber_t *mpsc_broadcast_subscribe(mpsc_broadcast_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    mpsc_broadcast_subscriber_t *subscriber = NULL;
+    for (size_t i = 0; i < self->n_max_subscribers; i++)
+    {
+        if (!self->subscribers[i].subscribed)
+        {
+            subscriber = &self->subscribers[i];
+            subscriber->subscribed = true;
+            subscriber->holding_message = false;
+            subscriber->cursor = self->write_sequence;
+            self->n_subscribers += 1;
+            break;
+        }
+    }
+    my_mutex_set_lock_state(&self->mutex, false);
+    return subscriber;
+}
+
+void mpsc_broadcast_unsubscribe(mpsc_broadcast_subscriber_t *self)
+{
+    mpsc_broadcast_t *broadcast = self->broadcast;
+    my_mutex_set_lock_state(&broadcast->mutex, true);
+    self->subscribed = false;
+    broadcast->n_subscribers -= 1;
+    // NOTE: The producer might be waiting on this subscriber's cursor.
+    my_condition_variable_signal(&broadcast->not_full_condition_variable);
+    my_mutex_set_lock_state(&broadcast->mutex, false);
+}
+
+bool mpsc_broadcast_send(mpsc_broadcast_t *self, void *data, size_t n)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    if (n > self->buffer_size)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] 'n = %zu' is greater than 'buffer_size = %zu'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, n, self->buffer_size);
+        abort();
+    }
+    while (!self->closed)
+    {
+        // NOTE: The slot about to be written is free once every subscriber's cursor
+        // is less than `capacity` messages behind the write sequence.
+        bool full = false;
+        for (size_t i = 0; i < self->n_max_subscribers; i++)
+        {
+            mpsc_broadcast_subscriber_t *subscriber = &self->subscribers[i];
+            if (
+                subscriber->subscribed &&
+                self->write_sequence - subscriber->cursor == self->capacity)
+            {
+                full = true;
+                break;
+            }
+        }
+        if (!full)
+        {
+            break;
+        }
+        my_condition_variable_wait(&self->not_full_condition_variable, &self->mutex);
+    }
+    if (self->closed)
+    {
+        my_mutex_set_lock_state(&self->mutex, false);
+        return false;
+    }
+    size_t slot = self->write_sequence % self->capacity;
+    if (n > 0)
+    {
+        memcpy((char *)self->buffer + slot * self->buffer_size, data, n);
+    }
+    self->sizes[slot] = n;
+    self->write_sequence += 1;
+    my_condition_variable_broadcast(&self->not_empty_condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+    return true;
+}
+
+void mpsc_broadcast_close(mpsc_broadcast_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    self->closed = true;
+    my_condition_variable_broadcast(&self->not_empty_condition_variable);
+    my_condition_variable_signal(&self->not_full_condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+}
+
+mpsc_broadcast_receive_status_t mpsc_broadcast_receive(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n)
+{
+    return mpsc_broadcast_receive_with_mode(self, data, n, true);
+}
+
+mpsc_broadcast_receive_status_t mpsc_broadcast_try_receive(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n)
+{
+    return mpsc_broadcast_receive_with_mode(self, data, n, false);
+}
+
+void mpsc_broadcast_release(mpsc_broadcast_subscriber_t *self)
+{
+    mpsc_broadcast_t *broadcast = self->broadcast;
+    my_mutex_set_lock_state(&broadcast->mutex, true);
+    if (!self->holding_message)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] subscriber %p is not holding a message\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+        abort();
+    }
+    self->holding_message = false;
+    self->cursor += 1;
+    my_condition_variable_signal(&broadcast->not_full_condition_variable);
+    my_mutex_set_lock_state(&broadcast->mutex, false);
+}
+
+static mpsc_broadcast_receive_status_t mpsc_broadcast_receive_with_mode(mpsc_broadcast_subscriber_t *self, const void **data, size_t *n, bool blocking)
+{
+    mpsc_broadcast_t *broadcast = self->broadcast;
+    my_mutex_set_lock_state(&broadcast->mutex, true);
+    while (
+        blocking &&
+        self->cursor == broadcast->write_sequence &&
+        !broadcast->closed)
+    {
+        my_condition_variable_wait(&broadcast->not_empty_condition_variable, &broadcast->mutex);
+    }
+    if (self->cursor == broadcast->write_sequence)
+    {
+        bool closed = broadcast->closed;
+        my_mutex_set_lock_state(&broadcast->mutex, false);
+        return closed ? MPSC_BROADCAST_RECEIVE_STATUS_CLOSED : MPSC_BROADCAST_RECEIVE_STATUS_EMPTY;
+    }
+    // NOTE: The slot can't be overwritten before this subscriber releases it, so
+    // the bytes can safely be read without holding the lock.
+    size_t slot = self->cursor % broadcast->capacity;
+    *n = broadcast->sizes[slot];
+    *data = *n > 0 ? (char *)broadcast->buffer + slot * broadcast->buffer_size : NULL;
+    self->holding_message = true;
+    my_mutex_set_lock_state(&broadcast->mutex, false);
+    return MPSC_BROADCAST_RECEIVE_STATUS_MESSAGE;
+}
+
+static void mpsc_broadcast_create_params_validate(mpsc_broadcast_create_params_t *params)
+{
+    if (params->capacity == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'capacity = 0'; requires at least 1\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (params->n_max_subscribers == 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'n_max_subscribers = 0'; requires at least 1\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+}
+
+mpsc_bridge_t *mpsc_bridge_create(mpsc_t *mpsc, mpsc_bridge_create_params_t params)
+{
+    mpsc_bridge_create_params_validate(&params);
+    bool handle_errors = params.error_handling_enabled;
+    mpsc_bridge_t *self = my_malloc(sizeof(mpsc_bridge_t), handle_errors);
+    if (self == NULL)
+    {
+        return NULL;
+    }
+    self->mpsc = mpsc;
+    self->producer = NULL;
+    self->socket_fd = -1;
+    self->stop_pipe[0] = -1;
+    self->stop_pipe[1] = -1;
+    self->path[0] = '\0';
+    self->batch_size = params.batch_size;
+    self->n_dropped_datagrams = 0;
+    size_t frame_size = mpsc->buffer_size > 0 ? mpsc->buffer_size : 1;
+    self->frames = my_malloc(frame_size * params.batch_size, handle_errors);
+    self->iovecs = self->frames == NULL ? NULL : my_malloc(sizeof(struct iovec) * params.batch_size, handle_errors);
+    self->headers = self->iovecs == NULL ? NULL : my_malloc(sizeof(my_datagram_header_t) * params.batch_size, handle_errors);
+    if (self->headers == NULL)
+    {
+        return mpsc_bridge_handle_creation_failure(self, ENOMEM, handle_errors);
+    }
+    for (size_t i = 0; i < params.batch_size; i++)
+    {
+        self->iovecs[i].iov_base = self->frames + i * frame_size;
+        self->iovecs[i].iov_len = mpsc->buffer_size;
+        memset(&self->headers[i], 0, sizeof(my_datagram_header_t));
+        self->headers[i].msg_hdr.msg_iov = &self->iovecs[i];
+        self->headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    if (pipe(self->stop_pipe) != 0)
+    {
+        return mpsc_bridge_handle_creation_failure(self, errno, handle_errors);
+    }
+#ifdef SOCK_CLOEXEC
+    self->socket_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+#else
+    self->socket_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (self->socket_fd >= 0)
+    {
+        fcntl(self->socket_fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (self->socket_fd < 0)
+    {
+        return mpsc_bridge_handle_creation_failure(self, errno, handle_errors);
+    }
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    memcpy(address.sun_path, params.path, strlen(params.path) + 1);
+    if (bind(self->socket_fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        return mpsc_bridge_handle_creation_failure(self, errno, handle_errors);
+    }
+    // NOTE: Only set once bound, since the path is unlinked on failure.
+    memcpy(self->path, params.path, strlen(params.path) + 1);
+    switch (mpsc_attach_producer(mpsc, &self->producer))
+    {
+    case MPSC_REGISTER_PRODUCER_ERROR_NONE:
+        break;
+    case MPSC_REGISTER_PRODUCER_ERROR_N_MAX_PRODUCERS_REACHED:
+        return mpsc_bridge_handle_creation_failure(self, EBUSY, handle_errors);
+    case MPSC_REGISTER_PRODUCER_ERROR_CLOSED:
+        return mpsc_bridge_handle_creation_failure(self, EPIPE, handle_errors);
+    default:
+        return mpsc_bridge_handle_creation_failure(self, errno, handle_errors);
+    }
+    if (!my_thread_create(&self->thread, my_bridge_thread_callback, self, handle_errors))
+    {
+        mpsc_producer_detach(self->producer);
+        self->producer = NULL;
+        return mpsc_bridge_handle_creation_failure(self, errno, handle_errors);
+    }
+    return self;
+}
+
+void mpsc_bridge_destroy(mpsc_bridge_t *self)
+{
+    // NOTE: A failed write would mean that the pipe is full, which can't happen
+    // since this is the only write.
+    ssize_t written = write(self->stop_pipe[1], "", 1);
+    (void)written;
+    my_thread_join(self->thread);
+    close(self->socket_fd);
+    close(self->stop_pipe[0]);
+    close(self->stop_pipe[1]);
+    unlink(self->path);
+    my_free(self->headers);
+    my_free(self->iovecs);
+    my_free(self->frames);
+    my_free(self);
+}
+
+uint64_t mpsc_bridge_n_dropped_datagrams(const mpsc_bridge_t *self)
+{
+    return __atomic_load_n(&self->n_dropped_datagrams, __ATOMIC_RELAXED);
+}
+
+static void *mpsc_bridge_handle_creation_failure(mpsc_bridge_t *self, int reason_code, bool handle_errors)
+{
+    if (!handle_errors)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] failed to create bridge with errno = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+    if (self->socket_fd >= 0)
+    {
+        close(self->socket_fd);
+    }
+    if (self->path[0] != '\0')
+    {
+        unlink(self->path);
+    }
+    if (self->stop_pipe[0] >= 0)
+    {
+        close(self->stop_pipe[0]);
+        close(self->stop_pipe[1]);
+    }
+    my_free(self->headers);
+    my_free(self->iovecs);
+    my_free(self->frames);
+    my_free(self);
+    errno = reason_code;
+    return NULL;
+}
+
+static void *my_bridge_thread_callback(void *context)
+{
+    mpsc_bridge_t *self = (mpsc_bridge_t *)context;
+    bool stopping = false;
+    bool closed = false;
+    while (
+        !stopping &&
+        !closed)
+    {
+        struct pollfd fds[2] = {
+            {.fd = self->socket_fd, .events = POLLIN},
+            {.fd = self->stop_pipe[0], .events = POLLIN},
+        };
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            my_io_failure("poll", __LINE__, __func__);
+        }
+        // NOTE: When stopping, the socket is still drained below, so that the
+        // datagrams sent before the call to `mpsc_bridge_destroy` are delivered.
+        stopping = (fds[1].revents & POLLIN) != 0;
+        while (!closed)
+        {
+            int count = my_receive_datagrams(self->socket_fd, self->headers, self->batch_size);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (
+                    errno == EAGAIN ||
+                    errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                my_io_failure("recvmmsg", __LINE__, __func__);
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            for (int i = 0; i < count && !closed; i++)
+            {
+                if ((self->headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+                {
+                    // NOTE: Larger than `buffer_size`, so it can't be delivered.
+                    my_counter_add(&self->n_dropped_datagrams, 1);
+                    continue;
+                }
+                size_t n = self->headers[i].msg_len;
+                closed = !mpsc_producer_send(self->producer, n > 0 ? self->iovecs[i].iov_base : NULL, n);
+            }
+        }
+    }
+    mpsc_producer_detach(self->producer);
+    return NULL;
+}
+
+#ifdef __linux__
+static mpsc_register_producer_error_t mpsc_fd_poller_create(mpsc_t *mpsc, mpsc_fd_poller_t **out)
+{
+    bool handle_errors = mpsc->error_handling_enabled;
+    mpsc_fd_poller_t *self = my_malloc(sizeof(mpsc_fd_poller_t), handle_errors);
+    if (self == NULL)
+    {
+        return MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+    }
+    self->mpsc = mpsc;
+    self->sources = NULL;
+    self->n_sources = 0;
+    self->stopping = false;
+    self->event_fd = -1;
+    mpsc_register_producer_error_t error = MPSC_REGISTER_PRODUCER_ERROR_NONE;
+    self->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (self->epoll_fd < 0)
+    {
+        error = mpsc_fd_poller_failure("epoll_create1", __LINE__, __func__, handle_errors);
+    }
+    else if ((self->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+    {
+        error = mpsc_fd_poller_failure("eventfd", __LINE__, __func__, handle_errors);
+    }
+    else
+    {
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+        if (epoll_ctl(self->epoll_fd, EPOLL_CTL_ADD, self->event_fd, &event) != 0)
+        {
+            error = mpsc_fd_poller_failure("epoll_ctl", __LINE__, __func__, handle_errors);
+        }
+    }
+    if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+    {
+        if (self->event_fd >= 0)
+        {
+            close(self->event_fd);
+        }
+        if (self->epoll_fd >= 0)
+        {
+            close(self->epoll_fd);
+        }
+        my_free(self);
+        return error;
+    }
+    error = MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+    if (my_mutex_init(&self->mutex, handle_errors))
+    {
+        error = mpsc_attach_producer(mpsc, &self->producer);
+        if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+        {
+            my_mutex_destroy(&self->mutex);
+        }
+    }
+    if (
+        error == MPSC_REGISTER_PRODUCER_ERROR_NONE &&
+        !my_thread_create(&self->thread, my_fd_poller_thread_callback, self, handle_errors))
+    {
+        mpsc_producer_detach(self->producer);
+        my_mutex_destroy(&self->mutex);
+        error = MPSC_REGISTER_PRODUCER_ERROR_EAGAIN;
+    }
+    if (error != MPSC_REGISTER_PRODUCER_ERROR_NONE)
+    {
+        close(self->event_fd);
+        close(self->epoll_fd);
+        my_free(self);
+        return error;
+    }
+    *out = self;
+    return MPSC_REGISTER_PRODUCER_ERROR_NONE;
+}
+
+static mpsc_register_producer_error_t mpsc_fd_poller_add(mpsc_fd_poller_t *self, mpsc_fd_source_t *source)
+{
+    // NOTE: Must be called with `self->mutex` held.
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = source};
+    if (epoll_ctl(self->epoll_fd, EPOLL_CTL_ADD, source->fd, &event) == 0)
+    {
+        return MPSC_REGISTER_PRODUCER_ERROR_NONE;
+    }
+    if (
+        errno == ENOMEM ||
+        errno == ENOSPC)
+    {
+        return mpsc_fd_poller_failure("epoll_ctl", __LINE__, __func__, self->mpsc->error_handling_enabled);
+    }
+    // NOTE: E.g., `EPERM` for a regular file, or `EEXIST` for an already registered
+    // file descriptor, which are reported whether or not errors are handled.
+    return MPSC_REGISTER_PRODUCER_ERROR_INVALID_FD;
+}
+
+static mpsc_register_producer_error_t mpsc_fd_poller_failure(const char *call, int line, const char *function, bool handle_errors)
+{
+    // NOTE: Running out of memory, file descriptors, or `epoll` watches is reported like
+    // the other allocation failures, while anything else terminates the process.
+    int custom_errno = errno;
+    if (handle_errors)
+    {
+        if (custom_errno == ENOMEM)
+        {
+            return MPSC_REGISTER_PRODUCER_ERROR_ENOMEM;
+        }
+        if (
+            custom_errno == EMFILE ||
+            custom_errno == ENFILE ||
+            custom_errno == ENOSPC)
+        {
+            return MPSC_REGISTER_PRODUCER_ERROR_EMFILE;
+        }
+    }
+    my_io_failure(call, line, function);
+    return MPSC_REGISTER_PRODUCER_ERROR_NONE;
+}
+#else
+// NOTE: Unreachable, since `mpsc_register_fd_source` terminates the process on platforms
+// without `epoll` (and `eventfd`), on which the poller thread isn't compiled.
+static mpsc_register_producer_error_t mpsc_fd_poller_create(mpsc_t *mpsc, mpsc_fd_poller_t **out)
+{
+    (void)mpsc;
+    (void)out;
+    abort();
+}
+
+static mpsc_register_producer_error_t mpsc_fd_poller_add(mpsc_fd_poller_t *self, mpsc_fd_source_t *source)
+{
+    (void)self;
+    (void)source;
+    abort();
+}
+#endif
+
+static void mpsc_fd_poller_destroy(mpsc_fd_poller_t *self)
+{
+    my_mutex_set_lock_state(&self->mutex, true);
+    self->stopping = true;
+    my_mutex_set_lock_state(&self->mutex, false);
+    uint64_t value = 1;
+    ssize_t written = write(self->event_fd, &value, sizeof(value));
+    (void)written;
+    my_thread_join(self->thread);
+    close(self->event_fd);
+    close(self->epoll_fd);
+    my_mutex_destroy(&self->mutex);
+    my_free(self);
+}
+
+static void mpsc_fd_poller_wake(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held.
+    if (self->fd_poller != NULL)
+    {
+        uint64_t value = 1;
+        ssize_t written = write(self->fd_poller->event_fd, &value, sizeof(value));
+        (void)written;
+    }
+}
+
+#ifdef __linux__
+static bool mpsc_fd_source_read(mpsc_fd_poller_t *self, mpsc_fd_source_t *source, bool *closed)
+{
+    // NOTE: Returns `false` once the source should be removed. Only one read is made per
+    // call (i.e., per event), so that a busy source can't starve the others.
+    mpsc_t *mpsc = self->mpsc;
+    size_t capacity = mpsc->buffer_size + MPSC_FD_SOURCE_READ_SIZE;
+    size_t limit = source->framing == NULL ? mpsc->buffer_size : capacity;
+    if (limit == 0)
+    {
+        // NOTE: Raw reads into a zero-sized buffer, which `read` can't distinguish from end-of-file.
+        return false;
+    }
+    ssize_t count = read(source->fd, source->buffer + source->length, limit - source->length);
+    if (count < 0)
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (count == 0)
+    {
+        return false;
+    }
+    source->length += (size_t)count;
+    size_t start = 0;
+    while (
+        start < source->length &&
+        !*closed)
+    {
+        size_t message_offset = 0;
+        size_t message_size = source->length - start;
+        size_t consumed = message_size;
+        if (source->framing != NULL)
+        {
+            consumed = (source->framing)(source->buffer + start, source->length - start, &message_offset, &message_size, source->context);
+            if (consumed == 0)
+            {
+                break;
+            }
+        }
+        if (
+            consumed > source->length - start ||
+            message_offset + message_size > consumed ||
+            message_size > mpsc->buffer_size)
+        {
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] framing function returned an invalid message (offset = %zu, size = %zu, consumed = %zu) for %zu bytes\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__, message_offset, message_size, consumed, source->length - start);
+            abort();
+        }
+        // NOTE: This blocks while the channel is full, in which case no file descriptor is read
+        // until it accepts the message.
+        void *data = message_size > 0 ? source->buffer + start + message_offset : NULL;
+        *closed = !mpsc_producer_send(self->producer, data, message_size);
+        start += consumed;
+    }
+    memmove(source->buffer, source->buffer + start, source->length - start);
+    source->length -= start;
+    // NOTE: A full buffer without a complete message means that it never will be.
+    return source->length < limit;
+}
+
+static void mpsc_fd_source_remove(mpsc_fd_poller_t *self, mpsc_fd_source_t *source)
+{
+    // NOTE: Must be called with `self->mutex` held. The file descriptor is closed right
+    // after, which would remove it from the epoll set anyway, so a failure is ignored.
+    epoll_ctl(self->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+    close(source->fd);
+    mpsc_fd_source_t **link = &self->sources;
+    while (*link != source)
+    {
+        link = &(*link)->next;
+    }
+    *link = source->next;
+    self->n_sources -= 1;
+    my_free(source->buffer);
+    my_free(source);
+}
+
+static void *my_fd_poller_thread_callback(void *context)
+{
+    mpsc_fd_poller_t *self = (mpsc_fd_poller_t *)context;
+    mpsc_t *mpsc = self->mpsc;
+    struct epoll_event events[MPSC_FD_POLLER_BATCH_SIZE];
+    bool closed = false;
+    while (!closed)
+    {
+        int count = epoll_wait(self->epoll_fd, events, MPSC_FD_POLLER_BATCH_SIZE, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] call to epoll_wait failed with errno = %i\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__, errno);
+            abort();
+        }
+        for (int i = 0; i < count && !closed; i++)
+        {
+            mpsc_fd_source_t *source = events[i].data.ptr;
+            if (source == NULL)
+            {
+                uint64_t value;
+                ssize_t n_read = read(self->event_fd, &value, sizeof(value));
+                (void)n_read;
+                continue;
+            }
+            if (!mpsc_fd_source_read(self, source, &closed))
+            {
+                my_mutex_set_lock_state(&self->mutex, true);
+                mpsc_fd_source_remove(self, source);
+                my_mutex_set_lock_state(&self->mutex, false);
+                // NOTE: A later event in this batch might refer to the removed source.
+                break;
+            }
+        }
+        my_mutex_set_lock_state(&mpsc->mutex, true);
+        my_mutex_set_lock_state(&self->mutex, true);
+        bool done = self->stopping || (mpsc->sealed && self->n_sources == 0);
+        my_mutex_set_lock_state(&self->mutex, false);
+        my_mutex_set_lock_state(&mpsc->mutex, false);
+        if (done)
+        {
+            break;
+        }
+    }
+    my_mutex_set_lock_state(&self->mutex, true);
+    while (self->sources != NULL)
+    {
+        mpsc_fd_source_remove(self, self->sources);
+    }
+    my_mutex_set_lock_state(&self->mutex, false);
+    mpsc_producer_detach(self->producer);
+    return NULL;
+}
+#endif
+
+static bool mpsc_spill_create(mpsc_t *self, mpsc_create_params_t *params)
+{
+    // NOTE: Segments are only created when messages are first spilled.
+    bool handle_errors = params->error_handling_enabled;
+    mpsc_spill_t *spill = my_malloc(sizeof(mpsc_spill_t), handle_errors);
+    if (spill == NULL)
+    {
+        return false;
+    }
+    size_t directory_size = strlen(params->spill_directory) + 1;
+    spill->directory = my_malloc(directory_size, handle_errors);
+    if (spill->directory == NULL)
+    {
+        my_free(spill);
+        return false;
+    }
+    memcpy(spill->directory, params->spill_directory, directory_size);
+    if (!my_condition_variable_init(&spill->drained_condition_variable, handle_errors))
+    {
+        int custom_errno = errno;
+        my_free(spill->directory);
+        my_free(spill);
+        errno = custom_errno;
+        return false;
+    }
+    spill->segment_size = params->spill_segment_size == 0 ? MPSC_SPILL_SEGMENT_SIZE : params->spill_segment_size;
+    spill->head = NULL;
+    spill->tail = NULL;
+    spill->free_segments = NULL;
+    spill->n_free_segments = 0;
+    spill->n_messages = 0;
+    self->spill = spill;
+    return true;
+}
+
+static void mpsc_spill_destroy(mpsc_t *self)
+{
+    mpsc_spill_t *spill = self->spill;
+    mpsc_spill_segment_t *lists[] = {spill->head, spill->free_segments};
+    for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++)
+    {
+        mpsc_spill_segment_t *segment = lists[i];
+        while (segment != NULL)
+        {
+            mpsc_spill_segment_t *next = segment->next;
+            munmap(segment->data, spill->segment_size);
+            my_free(segment);
+            segment = next;
+        }
+    }
+    my_condition_variable_destroy(&spill->drained_condition_variable);
+    my_free(spill->directory);
+    my_free(spill);
+    self->spill = NULL;
+}
+
+static bool mpsc_spill_is_empty(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held.
+    return self->spill == NULL || self->spill->n_messages == 0;
+}
+
+static bool mpsc_spill_push(mpsc_t *self, uint64_t key_hash, void *data, size_t n)
+{
+    // NOTE: Must be called with the lock held. Returns `false` when there is no
+    // spill, or when no segment could be created for the message.
+    mpsc_spill_t *spill = self->spill;
+    if (spill == NULL)
+    {
+        return false;
+    }
+    size_t record_size = MPSC_SPILL_RECORD_SIZE(n);
+    mpsc_spill_segment_t *segment = spill->tail;
+    if (
+        segment == NULL ||
+        segment->write_offset + record_size > spill->segment_size)
+    {
+        segment = mpsc_spill_segment_acquire(self);
+        if (segment == NULL)
+        {
+            return false;
+        }
+        if (spill->tail == NULL)
+        {
+            spill->head = segment;
+        }
+        else
+        {
+            spill->tail->next = segment;
+        }
+        spill->tail = segment;
+    }
+    // NOTE: Writes only touch the page cache; the kernel writes dirty pages back
+    // in the background, in large batches, so no system call is made per message.
+    mpsc_spill_record_header_t header = {.n = n, .key = key_hash, .enqueue_ns = mpsc_latency_now(self)};
+    memcpy(segment->data + segment->write_offset, &header, sizeof(header));
+    if (n > 0)
+    {
+        memcpy(segment->data + segment->write_offset + sizeof(header), data, n);
+    }
+    segment->write_offset += record_size;
+    spill->n_messages += 1;
+    return true;
+}
+
+static bool mpsc_spill_pop(mpsc_t *self, uint64_t *key_hash, void **data, size_t *n, uint64_t *enqueue_ns)
+{
+    // NOTE: Must be called with the lock held, while the spill isn't empty. As with
+    // `mpsc_consumer_copy_message`, a message that can't be copied is dropped.
+    mpsc_spill_t *spill = self->spill;
+    mpsc_spill_segment_t *segment = spill->head;
+    mpsc_spill_record_header_t header;
+    memcpy(&header, segment->data + segment->read_offset, sizeof(header));
+    void *buffer = NULL;
+    bool copied = true;
+    if (header.n > 0)
+    {
+        buffer = my_malloc(header.n, self->error_handling_enabled);
+        if (buffer == NULL)
+        {
+            copied = false;
+        }
+        else
+        {
+            memcpy(buffer, segment->data + segment->read_offset + sizeof(header), header.n);
+        }
+    }
+    segment->read_offset += MPSC_SPILL_RECORD_SIZE(header.n);
+    spill->n_messages -= 1;
+    if (spill->n_messages == 0)
+    {
+        // NOTE: The last segment is kept, and written to from the start again.
+        segment->read_offset = 0;
+        segment->write_offset = 0;
+        my_condition_variable_broadcast(&spill->drained_condition_variable);
+    }
+    else if (segment->read_offset == segment->write_offset)
+    {
+        // NOTE: Only the tail segment can still be written to, and it holds at least one message.
+        spill->head = segment->next;
+        mpsc_spill_segment_release(spill, segment);
+    }
+    *key_hash = header.key;
+    *data = buffer;
+    *n = header.n;
+    *enqueue_ns = header.enqueue_ns;
+    return copied;
+}
+
+static void mpsc_spill_wait_until_drained(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held. A producer that couldn't spill its message
+    // can only use the internal buffer once the spilled messages have been delivered.
+    while (
+        !self->closed &&
+        !mpsc_spill_is_empty(self))
+    {
+        my_condition_variable_wait(&self->spill->drained_condition_variable, &self->mutex);
+    }
+}
+
+static mpsc_spill_segment_t *mpsc_spill_segment_acquire(mpsc_t *self)
+{
+    // NOTE: Must be called with the lock held. Failing to create a segment file isn't
+    // reported, since the producer can still wait for the internal buffer.
+    mpsc_spill_t *spill = self->spill;
+    mpsc_spill_segment_t *segment = spill->free_segments;
+    if (segment != NULL)
+    {
+        spill->free_segments = segment->next;
+        spill->n_free_segments -= 1;
+        segment->read_offset = 0;
+        segment->write_offset = 0;
+        segment->next = NULL;
+        return segment;
+    }
+    segment = my_malloc(sizeof(mpsc_spill_segment_t), self->error_handling_enabled);
+    if (segment == NULL)
+    {
+        return NULL;
+    }
+    size_t path_size = strlen(spill->directory) + sizeof("/mpsc-spill-XXXXXX");
+    char *path = my_malloc(path_size, self->error_handling_enabled);
+    if (path == NULL)
+    {
+        my_free(segment);
+        return NULL;
+    }
+    snprintf(path, path_size, "%s/mpsc-spill-XXXXXX", spill->directory);
+    int fd = mkstemp(path);
+    if (fd == -1)
+    {
+        my_free(path);
+        my_free(segment);
+        return NULL;
+    }
+    // NOTE: The file goes away along with the mapping, even if the process crashes.
+    unlink(path);
+    my_free(path);
+    // NOTE: Allocating the file's blocks upfront makes a full disk fail here, rather
+    // than raise `SIGBUS` once the mapping is written to. Without `posix_fallocate`
+    // (e.g., on macOS), the file is only extended.
+    void *data = MAP_FAILED;
+#if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO > 0
+    int allocated = posix_fallocate(fd, 0, (off_t)spill->segment_size);
+#else
+    int allocated = ftruncate(fd, (off_t)spill->segment_size);
+#endif
+    if (allocated == 0)
+    {
+        data = mmap(NULL, spill->segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        my_free(segment);
+        return NULL;
+    }
+    madvise(data, spill->segment_size, MADV_SEQUENTIAL);
+    segment->data = data;
+    segment->read_offset = 0;
+    segment->write_offset = 0;
+    segment->next = NULL;
+    return segment;
+}
+
+static void mpsc_spill_segment_release(mpsc_spill_t *self, mpsc_spill_segment_t *segment)
+{
+    // NOTE: Must be called with the lock held. Recycled segments keep their file
+    // (and its allocated blocks), so reusing them doesn't touch the file system.
+    if (self->n_free_segments < MPSC_SPILL_MAX_FREE_SEGMENTS)
+    {
+        segment->next = self->free_segments;
+        self->free_segments = segment;
+        self->n_free_segments += 1;
+        return;
+    }
+    munmap(segment->data, self->segment_size);
+    my_free(segment);
+}
+
+static bool mpsc_wal_create(mpsc_t *self, mpsc_create_params_t *params)
+{
+    bool handle_errors = params->error_handling_enabled;
+    mpsc_wal_t *wal = my_malloc(sizeof(mpsc_wal_t), handle_errors);
+    if (wal == NULL)
+    {
+        return false;
+    }
+    size_t path_size = strlen(params->wal_path) + 1;
+    wal->path = my_malloc(path_size, handle_errors);
+    if (wal->path == NULL)
+    {
+        my_free(wal);
+        return false;
+    }
+    memcpy(wal->path, params->wal_path, path_size);
+    wal->fd = -1;
+    wal->replay_head = NULL;
+    wal->replay_tail = NULL;
+    wal->delivered_sequence = 0;
+    wal->syncing = false;
+    if (!my_condition_variable_init(&wal->turn_condition_variable, handle_errors))
+    {
+        int custom_errno = errno;
+        my_free(wal->path);
+        my_free(wal);
+        errno = custom_errno;
+        return false;
+    }
+    if (!my_condition_variable_init(&wal->synced_condition_variable, handle_errors))
+    {
+        int custom_errno = errno;
+        my_condition_variable_destroy(&wal->turn_condition_variable);
+        my_free(wal->path);
+        my_free(wal);
+        errno = custom_errno;
+        return false;
+    }
+    if (!my_mutex_init(&wal->sync_mutex, handle_errors))
+    {
+        int custom_errno = errno;
+        my_condition_variable_destroy(&wal->synced_condition_variable);
+        my_condition_variable_destroy(&wal->turn_condition_variable);
+        my_free(wal->path);
+        my_free(wal);
+        errno = custom_errno;
+        return false;
+    }
+    // NOTE: From here, `mpsc_wal_destroy` can clean up after a failure.
+    self->wal = wal;
+    return mpsc_wal_load(wal, handle_errors);
+}
+
+static void mpsc_wal_destroy(mpsc_t *self)
+{
+    mpsc_wal_t *wal = self->wal;
+    while (wal->replay_head != NULL)
+    {
+        mpsc_wal_replay_t *next = wal->replay_head->next;
+        my_free(wal->replay_head->data);
+        my_free(wal->replay_head);
+        wal->replay_head = next;
+    }
+    if (wal->fd != -1)
+    {
+        close(wal->fd);
+    }
+    my_mutex_destroy(&wal->sync_mutex);
+    my_condition_variable_destroy(&wal->synced_condition_variable);
+    my_condition_variable_destroy(&wal->turn_condition_variable);
+    my_free(wal->path);
+    my_free(wal);
+    self->wal = NULL;
+}
+
+static bool mpsc_wal_load(mpsc_wal_t *self, bool handle_errors)
+{
+    // NOTE: Reads the records left by a previous channel, up to the first one that is incomplete
+    // or corrupted (i.e., torn by a crash), keeping the messages that weren't acknowledged.
+    uint64_t max_sequence = 0;
+    uint64_t acked_sequence = 0;
+    int fd = open(self->path, O_RDONLY | O_CLOEXEC);
+    if (
+        fd == -1 &&
+        errno != ENOENT)
+    {
+        my_io_failure("open", __LINE__, __func__);
+    }
+    off_t remaining = 0;
+    if (fd != -1)
+    {
+        remaining = lseek(fd, 0, SEEK_END);
+        if (
+            remaining == -1 ||
+            lseek(fd, 0, SEEK_SET) == -1)
+        {
+            my_io_failure("lseek", __LINE__, __func__);
+        }
+    }
+    while (
+        fd != -1 &&
+        remaining >= (off_t)sizeof(mpsc_wal_record_header_t))
+    {
+        mpsc_wal_record_header_t header;
+        if (!my_read_all(fd, &header, sizeof(header)))
+        {
+            break;
+        }
+        remaining -= sizeof(header);
+        if (
+            (header.type != MPSC_WAL_RECORD_TYPE_MESSAGE && header.type != MPSC_WAL_RECORD_TYPE_ACK) ||
+            header.n > (uint64_t)remaining)
+        {
+            break;
+        }
+        void *data = NULL;
+        if (header.n > 0)
+        {
+            data = my_malloc(header.n, handle_errors);
+            if (data == NULL)
+            {
+                int custom_errno = errno;
+                close(fd);
+                errno = custom_errno;
+                return false;
+            }
+            if (!my_read_all(fd, data, header.n))
+            {
+                my_free(data);
+                break;
+            }
+            remaining -= header.n;
+        }
+        if (mpsc_wal_record_checksum(&header, data) != header.checksum)
+        {
+            my_free(data);
+            break;
+        }
+        max_sequence = header.sequence > max_sequence ? header.sequence : max_sequence;
+        if (header.type == MPSC_WAL_RECORD_TYPE_ACK)
+        {
+            acked_sequence = header.sequence > acked_sequence ? header.sequence : acked_sequence;
+            while (
+                self->replay_head != NULL &&
+                self->replay_head->sequence <= acked_sequence)
+            {
+                mpsc_wal_replay_t *next = self->replay_head->next;
+                my_free(self->replay_head->data);
+                my_free(self->replay_head);
+                self->replay_head = next;
+            }
+            if (self->replay_head == NULL)
+            {
+                self->replay_tail = NULL;
+            }
+            continue;
+        }
+        mpsc_wal_replay_t *entry = my_malloc(sizeof(mpsc_wal_replay_t), handle_errors);
+        if (entry == NULL)
+        {
+            int custom_errno = errno;
+            my_free(data);
+            close(fd);
+            errno = custom_errno;
+            return false;
+        }
+        entry->sequence = header.sequence;
+        entry->key_hash = header.key;
+        entry->data = data;
+        entry->n = header.n;
+        entry->next = NULL;
+        if (self->replay_tail == NULL)
+        {
+            self->replay_head = entry;
+        }
+        else
+        {
+            self->replay_tail->next = entry;
+        }
+        self->replay_tail = entry;
+    }
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    self->next_sequence = max_sequence + 1;
+    self->next_delivery_sequence = self->next_sequence;
+    self->pending_sequence = 0;
+    self->acked_sequence = acked_sequence;
+    self->written_sequence = max_sequence;
+    self->synced_sequence = max_sequence;
+    // NOTE: The remaining records are written to a new log, which then replaces the old one,
+    // so that a crash while compacting doesn't lose anything.
+    size_t path_size = strlen(self->path) + sizeof(".tmp");
+    char *temporary_path = my_malloc(path_size, handle_errors);
+    if (temporary_path == NULL)
+    {
+        return false;
+    }
+    snprintf(temporary_path, path_size, "%s.tmp", self->path);
+    fd = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        my_io_failure("open", __LINE__, __func__);
+    }
+    self->log_size = 0;
+    if (acked_sequence > 0)
+    {
+        mpsc_wal_write_record(fd, MPSC_WAL_RECORD_TYPE_ACK, acked_sequence, 0, NULL, 0);
+        self->log_size += sizeof(mpsc_wal_record_header_t);
+    }
+    for (mpsc_wal_replay_t *entry = self->replay_head; entry != NULL; entry = entry->next)
+    {
+        mpsc_wal_write_record(fd, MPSC_WAL_RECORD_TYPE_MESSAGE, entry->sequence, entry->key_hash, entry->data, entry->n);
+        self->log_size += sizeof(mpsc_wal_record_header_t) + entry->n;
+    }
+    if (my_fdatasync(fd) != 0)
+    {
+        my_io_failure("fdatasync", __LINE__, __func__);
+    }
+    close(fd);
+    if (rename(temporary_path, self->path) != 0)
+    {
+        my_io_failure("rename", __LINE__, __func__);
+    }
+    my_free(temporary_path);
+    mpsc_wal_sync_directory(self->path);
+    self->fd = open(self->path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (self->fd == -1)
+    {
+        my_io_failure("open", __LINE__, __func__);
+    }
+    return true;
+}
+
+static uint64_t mpsc_wal_append(mpsc_t *self, uint64_t key_hash, void *data, size_t n)
+{
+    // NOTE: Must be called with the lock held.
+    mpsc_wal_t *wal = self->wal;
+    uint64_t sequence = wal->next_sequence;
+    wal->next_sequence += 1;
+    mpsc_wal_write_record(wal->fd, MPSC_WAL_RECORD_TYPE_MESSAGE, sequence, key_hash, data, n);
+    wal->log_size += sizeof(mpsc_wal_record_header_t) + n;
+    __atomic_store_n(&wal->written_sequence, sequence, __ATOMIC_RELEASE);
+    return sequence;
+}
+
+static void mpsc_wal_sync(mpsc_wal_t *self, uint64_t sequence)
+{
+    // NOTE: Group commit: a producer whose record hasn't been synced yet either waits for the
+    // sync in progress, or (if there is none) syncs the log for every record written so far,
+    // which includes those of the producers that arrived during the previous sync.
+    my_mutex_set_lock_state(&self->sync_mutex, true);
+    while (self->synced_sequence < sequence)
+    {
+        if (self->syncing)
+        {
+            my_condition_variable_wait(&self->synced_condition_variable, &self->sync_mutex);
+            continue;
+        }
+        self->syncing = true;
+        uint64_t written_sequence = __atomic_load_n(&self->written_sequence, __ATOMIC_ACQUIRE);
+        my_mutex_set_lock_state(&self->sync_mutex, false);
+        if (my_fdatasync(self->fd) != 0)
+        {
+            my_io_failure("fdatasync", __LINE__, __func__);
+        }
+        my_mutex_set_lock_state(&self->sync_mutex, true);
+        self->syncing = false;
+        self->synced_sequence = written_sequence;
+        my_condition_variable_broadcast(&self->synced_condition_variable);
+    }
+    my_mutex_set_lock_state(&self->sync_mutex, false);
+}
+
+static void mpsc_wal_replay(mpsc_t *self)
+{
+    // NOTE: Called by the consumer thread before it delivers anything else, since the messages
+    // that weren't acknowledged are older than the new ones. Replayed messages are delivered
+    // even if the channel gets closed in the meantime.
+    mpsc_wal_t *wal = self->wal;
+    while (wal->replay_head != NULL)
+    {
+        mpsc_wal_replay_t *entry = wal->replay_head;
+        wal->replay_head = entry->next;
+        wal->delivered_sequence = entry->sequence;
+        // NOTE: The consumer callback takes ownership of `data`.
+        mpsc_consumer_deliver(self, &self->delivery_counters, entry->data, entry->n, 0);
+        my_free(entry);
+    }
+    wal->replay_tail = NULL;
+}
+
+static void mpsc_wal_write_record(int fd, mpsc_wal_record_type_t type, uint64_t sequence, uint64_t key_hash, const void *data, size_t n)
+{
+    mpsc_wal_record_header_t header = {
+        .type = type,
+        .sequence = sequence,
+        .key = key_hash,
+        .n = n,
+    };
+    header.checksum = mpsc_wal_record_checksum(&header, data);
+    struct iovec iovecs[2] = {
+        {.iov_base = &header, .iov_len = sizeof(header)},
+        {.iov_base = (void *)data, .iov_len = n},
+    };
+    int index = 0;
+    int count = n > 0 ? 2 : 1;
+    while (index < count)
+    {
+        ssize_t written = writev(fd, &iovecs[index], count - index);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            my_io_failure("writev", __LINE__, __func__);
+        }
+        size_t remaining = (size_t)written;
+        while (
+            index < count &&
+            remaining >= iovecs[index].iov_len)
+        {
+            remaining -= iovecs[index].iov_len;
+            index += 1;
+        }
+        if (index < count)
+        {
+            iovecs[index].iov_base = (char *)iovecs[index].iov_base + remaining;
+            iovecs[index].iov_len -= remaining;
+        }
+    }
+}
+
+static uint64_t mpsc_wal_record_checksum(const mpsc_wal_record_header_t *header, const void *data)
+{
+    // NOTE: 64-bit FNV-1a, over the header's other fields and the data.
+    uint64_t fields[] = {header->type, header->sequence, header->key, header->n};
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char *bytes = (const unsigned char *)fields;
+    for (size_t i = 0; i < sizeof(fields); i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < header->n; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void mpsc_wal_sync_directory(const char *path)
+{
+    // NOTE: Makes the log's (new) directory entry durable, after `rename`.
+    char directory[PATH_MAX];
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL)
+    {
+        snprintf(directory, sizeof(directory), ".");
+    }
+    else
+    {
+        size_t length = slash == path ? 1 : (size_t)(slash - path);
+        snprintf(directory, sizeof(directory), "%.*s", (int)length, path);
+    }
+    int fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (
+        fd == -1 ||
+        fsync(fd) != 0)
+    {
+        my_io_failure("fsync", __LINE__, __func__);
+    }
+    close(fd);
+}
+
+mpsc_trace_t *mpsc_trace_start(mpsc_t *mpsc, mpsc_trace_create_params_t params)
+{
+    size_t ring_size = params.producer_buffer_size == 0 ? MPSC_TRACE_BUFFER_SIZE : params.producer_buffer_size;
+    if (
+        params.payloads_enabled &&
+        ring_size < sizeof(mpsc_trace_record_header_t) + mpsc->buffer_size)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'producer_buffer_size = %zu'; requires at least %zu when 'payloads_enabled = true'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, ring_size, sizeof(mpsc_trace_record_header_t) + mpsc->buffer_size);
+        abort();
+    }
+    if (params.flush_interval_ms < 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid 'flush_interval_ms = %li'; must be 0 or greater\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, params.flush_interval_ms);
+        abort();
+    }
+    if (mpsc->process_shared)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] process-shared channels can't be traced\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
+        abort();
+    }
+    if (__atomic_load_n(&mpsc->trace, __ATOMIC_ACQUIRE) != NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] channel %p is already being traced\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)mpsc);
+        abort();
+    }
+    bool handle_errors = params.error_handling_enabled;
+    mpsc_trace_t *self = my_malloc(sizeof(mpsc_trace_t), handle_errors);
+    if (self == NULL)
+    {
+        return NULL;
+    }
+    self->mpsc = mpsc;
+    self->payloads_enabled = params.payloads_enabled;
+    self->ring_size = ring_size;
+    self->flush_interval_ms = params.flush_interval_ms == 0 ? MPSC_TRACE_FLUSH_INTERVAL_MS : params.flush_interval_ms;
+    self->n_dropped = 0;
+    self->stopping = false;
+    self->fd = -1;
+    self->rings = my_malloc(sizeof(mpsc_trace_ring_t *) * mpsc->n_max_producers, handle_errors);
+    if (self->rings == NULL)
+    {
+        return mpsc_trace_handle_creation_failure(self, ENOMEM, handle_errors);
+    }
+    for (size_t i = 0; i < mpsc->n_max_producers; i++)
+    {
+        self->rings[i] = NULL;
+    }
+    self->fd = open(params.path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (self->fd == -1)
+    {
+        return mpsc_trace_handle_creation_failure(self, errno, handle_errors);
+    }
+    mpsc_trace_write(self->fd, MPSC_TRACE_MAGIC, strlen(MPSC_TRACE_MAGIC));
+    if (!my_mutex_init(&self->mutex, handle_errors))
+    {
+        return mpsc_trace_handle_creation_failure(self, errno, handle_errors);
+    }
+    if (!my_condition_variable_init(&self->condition_variable, handle_errors))
+    {
+        int custom_errno = errno;
+        my_mutex_destroy(&self->mutex);
+        return mpsc_trace_handle_creation_failure(self, custom_errno, handle_errors);
+    }
+    if (!my_thread_create(&self->thread, my_trace_writer_thread_callback, self, handle_errors))
+    {
+        int custom_errno = errno;
+        my_condition_variable_destroy(&self->condition_variable);
+        my_mutex_destroy(&self->mutex);
+        return mpsc_trace_handle_creation_failure(self, custom_errno, handle_errors);
+    }
+    self->start_ns = my_monotonic_ns();
+    __atomic_store_n(&mpsc->trace, self, __ATOMIC_SEQ_CST);
+    return self;
+}
+
+uint64_t mpsc_trace_stop(mpsc_trace_t *self)
+{
+    // NOTE: A producer only accesses the recorder between setting and unsetting its `tracing` flag,
+    // and reads `trace` in between, so once `trace` is unset and no slot's flag is set, no producer
+    // can access it anymore. Slots created afterwards can only see `trace = NULL`.
+    mpsc_t *mpsc = self->mpsc;
+    __atomic_store_n(&mpsc->trace, NULL, __ATOMIC_SEQ_CST);
+    my_mutex_set_lock_state(&mpsc->mutex, true);
+    size_t n_producer_slots = mpsc->n_producer_slots;
+    my_mutex_set_lock_state(&mpsc->mutex, false);
+    for (size_t i = 0; i < n_producer_slots; i++)
+    {
+        mpsc_producer_t *producer = mpsc_producer_slot(mpsc, i);
+        while (__atomic_load_n(&producer->tracing, __ATOMIC_SEQ_CST) != 0)
+        {
+            sched_yield();
+        }
+    }
+    my_mutex_set_lock_state(&self->mutex, true);
+    self->stopping = true;
+    my_condition_variable_signal(&self->condition_variable);
+    my_mutex_set_lock_state(&self->mutex, false);
+    my_thread_join(self->thread);
+    uint64_t n_dropped = self->n_dropped;
+    for (size_t i = 0; i < mpsc->n_max_producers; i++)
+    {
+        if (self->rings[i] != NULL)
+        {
+            n_dropped += self->rings[i]->n_dropped;
+            my_free(self->rings[i]);
+        }
+    }
+    close(self->fd);
+    my_condition_variable_destroy(&self->condition_variable);
+    my_mutex_destroy(&self->mutex);
+    my_free(self->rings);
+    my_free(self);
+    return n_dropped;
+}
+
+static void mpsc_trace_record(mpsc_producer_t *producer, const void *data, size_t n)
+{
+    // NOTE: Only costs an atomic load while the channel isn't being traced. Otherwise, the
+    // flag is only written to by this producer, so its cache line isn't shared with others.
+    mpsc_t *mpsc = producer->mpsc;
+    if (__atomic_load_n(&mpsc->trace, __ATOMIC_RELAXED) == NULL)
+    {
+        return;
+    }
+    __atomic_store_n(&producer->tracing, 1, __ATOMIC_SEQ_CST);
+    mpsc_trace_t *trace = __atomic_load_n(&mpsc->trace, __ATOMIC_SEQ_CST);
+    if (trace != NULL)
+    {
+        mpsc_trace_append(trace, producer->id, data, n);
+    }
+    __atomic_store_n(&producer->tracing, 0, __ATOMIC_RELEASE);
+}
+
+static void mpsc_trace_append(mpsc_trace_t *self, size_t producer_id, const void *data, size_t n)
+{
+    // NOTE: Called by the producer that owns the ring (producers attached by `mpsc_send_any`'s
+    // callers, the bridge and the file descriptor poller are all used by a single thread at once).
+    mpsc_trace_ring_t *ring = __atomic_load_n(&self->rings[producer_id], __ATOMIC_ACQUIRE);
+    if (ring == NULL)
+    {
+        // NOTE: A ring that can't be allocated only drops the record, whatever
+        // the channel's `error_handling_enabled`.
+        ring = my_malloc(sizeof(mpsc_trace_ring_t) + self->ring_size, true);
+        if (ring == NULL)
+        {
+            __atomic_add_fetch(&self->n_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        ring->head = 0;
+        ring->tail = 0;
+        ring->n_dropped = 0;
+        __atomic_store_n(&self->rings[producer_id], ring, __ATOMIC_RELEASE);
+    }
+    mpsc_trace_record_header_t header = {
+        .timestamp_ns = my_monotonic_ns() - self->start_ns,
+        .n = n,
+        .producer_index = (uint32_t)producer_id,
+        .flags = self->payloads_enabled ? MPSC_TRACE_RECORD_FLAG_PAYLOAD : 0,
+    };
+    size_t payload_size = self->payloads_enabled ? n : 0;
+    uint64_t head = ring->head;
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (self->ring_size - (head - tail) < sizeof(header) + payload_size)
+    {
+        ring->n_dropped += 1;
+        return;
+    }
+    mpsc_trace_ring_write(self, ring, head, &header, sizeof(header));
+    mpsc_trace_ring_write(self, ring, head + sizeof(header), data, payload_size);
+    __atomic_store_n(&ring->head, head + sizeof(header) + payload_size, __ATOMIC_RELEASE);
+}
+
+static void mpsc_trace_ring_write(mpsc_trace_t *self, mpsc_trace_ring_t *ring, uint64_t position, const void *data, size_t n)
+{
+    // NOTE: Records can wrap around the end of the ring.
+    size_t offset = (size_t)(position % self->ring_size);
+    size_t first = n < self->ring_size - offset ? n : self->ring_size - offset;
+    if (first > 0)
+    {
+        memcpy(ring->data + offset, data, first);
+    }
+    if (n > first)
+    {
+        memcpy(ring->data, (const char *)data + first, n - first);
+    }
+}
+
+static void mpsc_trace_flush(mpsc_trace_t *self)
+{
+    // NOTE: Only called by the writer thread. Since `head` is only advanced once a whole
+    // record has been written, only whole records are flushed.
+    for (size_t i = 0; i < self->mpsc->n_max_producers; i++)
+    {
+        mpsc_trace_ring_t *ring = __atomic_load_n(&self->rings[i], __ATOMIC_ACQUIRE);
+        if (ring == NULL)
+        {
+            continue;
+        }
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t tail = ring->tail;
+        while (tail < head)
+        {
+            size_t offset = (size_t)(tail % self->ring_size);
+            size_t n = head - tail < self->ring_size - offset ? (size_t)(head - tail) : self->ring_size - offset;
+            mpsc_trace_write(self->fd, ring->data + offset, n);
+            tail += n;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+static void mpsc_trace_write(int fd, const void *data, size_t n)
+{
+    size_t offset = 0;
+    while (offset < n)
+    {
+        ssize_t written = write(fd, (const char *)data + offset, n - offset);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            my_io_failure("write", __LINE__, __func__);
+        }
+        offset += (size_t)written;
+    }
 }
 
-void mpsc_consumer_close(mpsc_consumer_t *self)
+static void *mpsc_trace_handle_creation_failure(mpsc_trace_t *self, int reason_code, bool handle_errors)
 {
-    my_mutex_set_lock_state(&self->mpsc->mutex, true);
-    self->mpsc->closed = true;
-    my_condition_variable_signal(&self->mpsc->condition_variable);
-    for (size_t i = 0; i < self->mpsc->n_producers_waiting; i++)
+    if (!handle_errors)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] failed to start trace with errno = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+    if (self->fd != -1)
     {
-        size_t index = self->mpsc->producer_waiting_ids_queue[i];
-        my_condition_variable_signal(&self->mpsc->producer_condition_variables[index]);
+        close(self->fd);
     }
-    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    my_free(self->rings);
+    my_free(self);
+    errno = reason_code;
+    return NULL;
 }
 
-bool mpsc_producer_ping(mpsc_producer_t *self)
+static void *my_trace_writer_thread_callback(void *context)
 {
-    my_mutex_set_lock_state(&self->mpsc->mutex, true);
-    bool ok = true;
-    if (self->mpsc->closed)
+    mpsc_trace_t *self = (mpsc_trace_t *)context;
+    bool stopping = false;
+    while (!stopping)
     {
-        ok = false;
+        struct timespec deadline;
+        my_deadline_from_timeout(&deadline, self->flush_interval_ms);
+        my_mutex_set_lock_state(&self->mutex, true);
+        while (
+            !self->stopping &&
+            my_condition_variable_timed_wait(&self->condition_variable, &self->mutex, &deadline))
+        {
+        }
+        stopping = self->stopping;
+        my_mutex_set_lock_state(&self->mutex, false);
+        // NOTE: Once stopping, no producer records anymore, so this last flush empties the rings.
+        mpsc_trace_flush(self);
     }
-    my_mutex_set_lock_state(&self->mpsc->mutex, false);
-    return ok;
+    return NULL;
 }
 
-bool mpsc_producer_send(mpsc_producer_t *self, void *data, size_t n)
+bool mpsc_trace_replay(mpsc_t *mpsc, mpsc_trace_replay_params_t params)
 {
-    my_mutex_set_lock_state(&self->mpsc->mutex, true);
-    if (n > self->mpsc->buffer_size)
+    if (params.speedup < 0)
     {
         fprintf(
             stderr,
-            "%s:%i %s [Fatal Error] 'n = %zu' is greater than 'buffer_size = %zu'\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__, n, self->mpsc->buffer_size);
+            "%s:%i %s [Fatal Error] invalid 'speedup = %f'; must be 0 or greater\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, params.speedup);
         abort();
     }
-    if (self->mpsc->closed)
+    bool handle_errors = params.error_handling_enabled;
+    mpsc_trace_replay_t *self = my_malloc(sizeof(mpsc_trace_replay_t), handle_errors);
+    if (self == NULL)
     {
-        my_mutex_set_lock_state(&self->mpsc->mutex, false);
         return false;
     }
-    // NOTE: Checking for these two conditions here is very important, else
-    // some races will occur when we have a waiting producer that gets signaled
-    // but at the same time a new message is free of sending because `message_pending = false`.
-    // What happens is that the "free" sent message gets overriden by the waiting one.
-    if (self->mpsc->pending_message || self->mpsc->next_waiting_producer_id != -1)
+    self->mpsc = mpsc;
+    self->speedup = params.speedup == 0 ? 1.0 : params.speedup;
+    self->file = NULL;
+    self->zeros = NULL;
+    self->producers = NULL;
+    self->n_producers = 0;
+    self->records = NULL;
+    int fd = open(params.path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
     {
-        size_t id = mpsc_producer_subscribe_to_wait_queue(self);
-        pthread_cond_t *condition_variable = &self->mpsc->producer_condition_variables[id];
-        while (
-            !self->mpsc->closed &&
-            self->mpsc->next_waiting_producer_id != (ssize_t)id)
+        return mpsc_trace_replay_finish(self, errno, handle_errors);
+    }
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (
+        size == -1 ||
+        lseek(fd, 0, SEEK_SET) == -1)
+    {
+        my_io_failure("lseek", __LINE__, __func__);
+    }
+    self->file = my_malloc((size_t)size + 1, handle_errors);
+    if (self->file == NULL)
+    {
+        close(fd);
+        return mpsc_trace_replay_finish(self, ENOMEM, handle_errors);
+    }
+    bool complete = my_read_all(fd, self->file, (size_t)size);
+    close(fd);
+    if (
+        !complete ||
+        (size_t)size < strlen(MPSC_TRACE_MAGIC) ||
+        memcmp(self->file, MPSC_TRACE_MAGIC, strlen(MPSC_TRACE_MAGIC)) != 0)
+    {
+        return mpsc_trace_replay_finish(self, EINVAL, handle_errors);
+    }
+    // NOTE: The records are scanned three times: to count them (and find the highest producer index),
+    // to count each producer's records, and to point each producer to its slice of `records`.
+    size_t offset = strlen(MPSC_TRACE_MAGIC);
+    size_t n_records = 0;
+    size_t n_indices = 0;
+    const char *record;
+    mpsc_trace_record_header_t header;
+    while ((record = mpsc_trace_next_record(self->file, (size_t)size, &offset, &header)) != NULL)
+    {
+        n_records += 1;
+        n_indices = (size_t)header.producer_index + 1 > n_indices ? (size_t)header.producer_index + 1 : n_indices;
+    }
+    self->records = my_malloc(sizeof(const char *) * (n_records > 0 ? n_records : 1), handle_errors);
+    self->producers = self->records == NULL ? NULL : my_malloc(sizeof(mpsc_trace_replay_producer_t) * (n_indices > 0 ? n_indices : 1), handle_errors);
+    self->zeros = self->producers == NULL ? NULL : my_malloc(mpsc->buffer_size > 0 ? mpsc->buffer_size : 1, handle_errors);
+    if (self->zeros == NULL)
+    {
+        return mpsc_trace_replay_finish(self, ENOMEM, handle_errors);
+    }
+    memset(self->zeros, 0, mpsc->buffer_size);
+    self->n_producers = n_indices;
+    for (size_t i = 0; i < n_indices; i++)
+    {
+        self->producers[i].replay = self;
+        self->producers[i].producer = NULL;
+        self->producers[i].n_records = 0;
+    }
+    offset = strlen(MPSC_TRACE_MAGIC);
+    while ((record = mpsc_trace_next_record(self->file, (size_t)size, &offset, &header)) != NULL)
+    {
+        self->producers[header.producer_index].n_records += 1;
+    }
+    size_t first = 0;
+    for (size_t i = 0; i < n_indices; i++)
+    {
+        self->producers[i].records = self->records + first;
+        first += self->producers[i].n_records;
+        self->producers[i].n_records = 0;
+    }
+    offset = strlen(MPSC_TRACE_MAGIC);
+    while ((record = mpsc_trace_next_record(self->file, (size_t)size, &offset, &header)) != NULL)
+    {
+        mpsc_trace_replay_producer_t *producer = &self->producers[header.producer_index];
+        producer->records[producer->n_records] = record;
+        producer->n_records += 1;
+    }
+    // NOTE: All producers are attached before any thread starts, so that a failure
+    // doesn't leave part of the trace replayed.
+    for (size_t i = 0; i < self->n_producers; i++)
+    {
+        if (self->producers[i].n_records == 0)
         {
-            my_condition_variable_wait(condition_variable, &self->mpsc->mutex);
+            continue;
         }
-        if (self->mpsc->closed)
+        switch (mpsc_attach_producer(mpsc, &self->producers[i].producer))
         {
-            my_mutex_set_lock_state(&self->mpsc->mutex, false);
-            return false;
+        case MPSC_REGISTER_PRODUCER_ERROR_NONE:
+            break;
+        case MPSC_REGISTER_PRODUCER_ERROR_N_MAX_PRODUCERS_REACHED:
+            return mpsc_trace_replay_finish(self, EBUSY, handle_errors);
+        case MPSC_REGISTER_PRODUCER_ERROR_CLOSED:
+            return mpsc_trace_replay_finish(self, EPIPE, handle_errors);
+        default:
+            return mpsc_trace_replay_finish(self, errno, handle_errors);
         }
-        //  NOTE: Technically, once closed, shifting this no longer
-        //  helps, because the condition does necessarily mean that
-        //  `self->mpsc->next_waiting_producer_id != (ssize_t)id`. On
-        //  the other hand, if the while loop breaks because id == producer_id,
-        //  then we know shifting is for the appropriate waiting producer.
-        mpsc_shift_producer_wait_queue(self->mpsc);
     }
-    if (n > 0)
+    self->start_ns = my_monotonic_ns();
+    int reason_code = 0;
+    size_t n_started = 0;
+    for (; n_started < self->n_producers; n_started++)
     {
-        memcpy(self->mpsc->buffer, data, n);
+        mpsc_trace_replay_producer_t *producer = &self->producers[n_started];
+        if (
+            producer->producer != NULL &&
+            !my_thread_create(&producer->thread, my_trace_replay_thread_callback, producer, handle_errors))
+        {
+            reason_code = errno;
+            break;
+        }
     }
-    self->mpsc->n = n;
-    self->mpsc->pending_message = true;
-    my_condition_variable_signal(&self->mpsc->condition_variable);
-    my_mutex_set_lock_state(&self->mpsc->mutex, false);
-    return true;
-}
-
-bool mpsc_producer_send_empty(mpsc_producer_t *self)
-{
-    return mpsc_producer_send(self, NULL, 0);
-}
-
-static void mpsc_producer_done(mpsc_producer_t *self)
-{
-    my_mutex_set_lock_state(&self->mpsc->mutex, true);
-    if (!self->done)
+    for (size_t i = 0; i < n_started; i++)
     {
-        self->done = true;
-        self->mpsc->n_producers_closed += 1;
-        if (
-            self->mpsc->n_producers_closed == self->mpsc->producer_count &&
-            self->mpsc->joined)
+        if (self->producers[i].producer != NULL)
         {
-            self->mpsc->closed = true;
-            my_condition_variable_signal(&self->mpsc->condition_variable);
+            my_thread_join(self->producers[i].thread);
         }
     }
-    my_mutex_set_lock_state(&self->mpsc->mutex, false);
+    if (reason_code != 0)
+    {
+        return mpsc_trace_replay_finish(self, reason_code, handle_errors);
+    }
+    return mpsc_trace_replay_finish(self, 0, handle_errors);
 }
 
-void *mpsc_producer_context(mpsc_producer_t *self)
+static const char *mpsc_trace_next_record(const char *file, size_t size, size_t *offset, mpsc_trace_record_header_t *header)
 {
-    return self->application_context;
+    // NOTE: Returns the record at `offset` (copying its header, since records aren't aligned), and moves
+    // `offset` past it, or returns `NULL` once there are no complete records left (e.g., after a crash).
+    if (size - *offset < sizeof(mpsc_trace_record_header_t))
+    {
+        return NULL;
+    }
+    memcpy(header, file + *offset, sizeof(mpsc_trace_record_header_t));
+    uint64_t payload_size = (header->flags & MPSC_TRACE_RECORD_FLAG_PAYLOAD) ? header->n : 0;
+    if (payload_size > size - *offset - sizeof(mpsc_trace_record_header_t))
+    {
+        return NULL;
+    }
+    const char *record = file + *offset;
+    *offset += sizeof(mpsc_trace_record_header_t) + payload_size;
+    return record;
 }
 
-mpsc_register_producer_error_t mpsc_producer_register_producer(mpsc_producer_t *self, mpsc_producer_thread_callback_t callback, void *context)
+static bool mpsc_trace_replay_finish(mpsc_trace_replay_t *self, int reason_code, bool handle_errors)
 {
-    return mpsc_register_producer(self->mpsc, callback, context);
+    // NOTE: Detaches the producers and releases the replay, after it's done (i.e., `reason_code = 0`)
+    // or after a failure.
+    if (
+        reason_code != 0 &&
+        !handle_errors)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] failed to replay trace with errno = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+    for (size_t i = 0; i < self->n_producers; i++)
+    {
+        if (self->producers[i].producer != NULL)
+        {
+            mpsc_producer_detach(self->producers[i].producer);
+        }
+    }
+    my_free(self->producers);
+    my_free(self->records);
+    my_free(self->zeros);
+    my_free(self->file);
+    my_free(self);
+    if (reason_code != 0)
+    {
+        errno = reason_code;
+    }
+    return reason_code == 0;
 }
 
-static size_t mpsc_producer_subscribe_to_wait_queue(mpsc_producer_t *self)
+static void *my_trace_replay_thread_callback(void *context)
 {
-    ssize_t index = -1;
-    for (size_t i = 0; i < self->mpsc->n_max_producers; i++)
+    mpsc_trace_replay_producer_t *self = (mpsc_trace_replay_producer_t *)context;
+    mpsc_trace_replay_t *replay = self->replay;
+    for (size_t i = 0; i < self->n_records; i++)
     {
-        if (&self->mpsc->producers[i] == self)
+        mpsc_trace_record_header_t header;
+        memcpy(&header, self->records[i], sizeof(header));
+        uint64_t target_ns = replay->start_ns + (uint64_t)((double)header.timestamp_ns / replay->speedup);
+        my_sleep_until_ns(target_ns);
+        size_t n = header.n < replay->mpsc->buffer_size ? (size_t)header.n : replay->mpsc->buffer_size;
+        void *data = (header.flags & MPSC_TRACE_RECORD_FLAG_PAYLOAD) ? (void *)(self->records[i] + sizeof(header)) : replay->zeros;
+        if (!mpsc_producer_send(self->producer, data, n))
         {
-            index = i;
             break;
         }
     }
-    if (index == -1)
+    return NULL;
+}
+
+static void mpsc_bridge_create_params_validate(mpsc_bridge_create_params_t *params)
+{
+    if (
+        params->path == NULL ||
+        params->path[0] == '\0' ||
+        strlen(params->path) >= sizeof(((struct sockaddr_un *)NULL)->sun_path))
     {
         fprintf(
             stderr,
-            "%s:%i %s [Fatal Error] producer %p not found in list\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__, (void *)self);
+            "%s:%i %s [Fatal Error] invalid 'path'; must be a non-empty string shorter than %zu bytes\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, sizeof(((struct sockaddr_un *)NULL)->sun_path));
         abort();
     }
-    size_t id = (size_t)index;
-    if (self->mpsc->n_producers_waiting == self->mpsc->n_max_producers)
+    if (params->batch_size == 0)
     {
         fprintf(
             stderr,
-            "%s:%i %s [Fatal Error] producer 'id = %zu' (%p) has already subscribed to waiting list\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__, id, (void *)self);
+            "%s:%i %s [Fatal Error] invalid 'batch_size = 0'; requires at least 1\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__);
         abort();
     }
-    self->mpsc->producer_waiting_ids_queue[self->mpsc->n_producers_waiting] = id;
-    self->mpsc->n_producers_waiting += 1;
-    return id;
 }
 
-static void mpsc_shift_producer_wait_queue(mpsc_t *self)
+struct my_cached_thread_s
+{
+    pthread_cond_t condition_variable;
+    void *(*callback)(void *context);
+    void *context;
+    my_thread_t *thread;
+    bool evicted;
+    my_cached_thread_t *next;
+    // NOTE: Set by the thread itself, with the cache's lock held, so that it can
+    // be joined once it has moved itself to the exited threads list.
+    pthread_t id;
+};
+
+static struct
+{
+    pthread_mutex_t mutex;
+    // NOTE: Broadcast whenever a cached thread finishes running a callback,
+    // which is what `my_thread_wait` waits on.
+    pthread_cond_t finished_condition_variable;
+    size_t max_idle_threads;
+    long idle_timeout_ms;
+    size_t n_idle_threads;
+    my_cached_thread_t *idle_threads;
+    // NOTE: The number of cached threads that haven't exited yet (whether idle or
+    // running a callback), and the exited ones, which are yet to be joined (see
+    // `my_thread_cache_reap`).
+    size_t n_threads;
+    my_cached_thread_t *exited_threads;
+} my_thread_cache = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .finished_condition_variable = PTHREAD_COND_INITIALIZER,
+    .max_idle_threads = 0,
+    .idle_timeout_ms = 0,
+    .n_idle_threads = 0,
+    .idle_threads = NULL,
+    .n_threads = 0,
+    .exited_threads = NULL,
+};
+
+void mpsc_thread_cache_configure(mpsc_thread_cache_params_t params)
 {
-    if (self->n_producers_waiting == 0)
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    my_thread_cache.max_idle_threads = params.max_idle_threads;
+    my_thread_cache.idle_timeout_ms = params.idle_timeout_ms;
+    while (my_thread_cache.n_idle_threads > my_thread_cache.max_idle_threads)
     {
-        fprintf(
-            stderr,
-            "%s:%i %s [Fatal Error] empty queue\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__);
-        abort();
+        my_cached_thread_t *cached_thread = my_thread_cache.idle_threads;
+        my_thread_cache.idle_threads = cached_thread->next;
+        my_thread_cache.n_idle_threads -= 1;
+        cached_thread->evicted = true;
+        my_condition_variable_signal(&cached_thread->condition_variable);
     }
-    for (size_t i = 0; i < self->n_producers_waiting - 1; i++)
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+    my_thread_cache_reap();
+}
+
+void mpsc_thread_cache_drain(void)
+{
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    my_thread_cache.max_idle_threads = 0;
+    while (my_thread_cache.idle_threads != NULL)
     {
-        self->producer_waiting_ids_queue[i] = self->producer_waiting_ids_queue[i + 1];
+        my_cached_thread_t *cached_thread = my_thread_cache.idle_threads;
+        my_thread_cache.idle_threads = cached_thread->next;
+        my_thread_cache.n_idle_threads -= 1;
+        cached_thread->evicted = true;
+        my_condition_variable_signal(&cached_thread->condition_variable);
     }
-    self->n_producers_waiting -= 1;
-    self->next_waiting_producer_id = -1;
+    // NOTE: Threads that are running a callback exit as soon as it returns, since
+    // the cache is now disabled.
+    while (my_thread_cache.n_threads > 0)
+    {
+        my_condition_variable_wait(&my_thread_cache.finished_condition_variable, &my_thread_cache.mutex);
+    }
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+    my_thread_cache_reap();
 }
 
-static void mpsc_destroy(mpsc_t *self)
+static void my_thread_cache_reap(void)
 {
-    my_mutex_destroy(&self->mutex);
-    my_condition_variable_destroy(&self->condition_variable);
-    for (size_t i = 0; i < self->n_max_producers; i++)
+    // NOTE: A thread only moves itself to the exited list right before returning, so
+    // joining it doesn't wait for long, and can be done without holding the lock.
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    my_cached_thread_t *cached_thread = my_thread_cache.exited_threads;
+    my_thread_cache.exited_threads = NULL;
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+    while (cached_thread != NULL)
     {
-        my_condition_variable_destroy(&self->producer_condition_variables[i]);
+        my_cached_thread_t *next = cached_thread->next;
+        my_thread_join(cached_thread->id);
+        my_condition_variable_destroy(&cached_thread->condition_variable);
+        my_free(cached_thread);
+        cached_thread = next;
     }
-    my_free(self->producer_condition_variables);
-    my_free(self->producer_waiting_ids_queue);
-    my_free(self->buffer);
-    my_free(self->producer_thread_ids);
-    my_free(self->producers);
-    my_free(self);
 }
 
-static void *mpsc_handle_creation_failure(mpsc_t *self, mpsc_handle_creation_failure_type_t type, ssize_t producer_cond_var_index)
+static void my_thread_attributes_validate(const mpsc_thread_attributes_t *attributes, const char *field_name)
 {
-    // NOTE: The `ssize_t producer_cond_var_index` argument was added later on, along with the
-    // new `self->producer_condition_variables` array, to be able to indicate up to which
-    // to destroy, if needed. That said, this function could be refactored to take
-    // a structure of settings for the second argument, instead of having `producer_cond_var_index`, but
-    // it's OK for now I guess. But if other arguments are needed in the future, this should be
-    // converted to a structure...
-    int custom_errno;
-    switch (errno)
+#ifndef __linux__
+    if (
+        attributes->n_cpus > 0 ||
+        attributes->name != NULL)
     {
-    case ENOMEM:
-        custom_errno = ENOMEM;
-        break;
-    case EAGAIN:
-        custom_errno = EAGAIN;
-        break;
-    default:
         fprintf(
             stderr,
-            "%s:%i %s [Fatal Error] 'errno = %i' no supported by this call\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__, errno);
+            "%s:%i %s [Fatal Error] '%s.cpus' and '%s.name' are only supported on Linux\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, field_name, field_name);
         abort();
     }
-    switch (type)
+#endif
+    if (
+        attributes->stack_size != 0 &&
+        attributes->stack_size < (size_t)PTHREAD_STACK_MIN)
     {
-    case MPSC_HANDLE_CREATION_FAILURE_THREAD_CREATE:
-        my_mutex_destroy(&self->mutex);
-        my_condition_variable_destroy(&self->condition_variable);
-        for (size_t i = 0; i < self->n_max_producers; i++)
-        {
-            my_condition_variable_destroy(&self->producer_condition_variables[i]);
-        }
-        break;
-    case MPSC_HANDLE_CREATION_FAILURE_MUTEX_INIT:
-        my_condition_variable_destroy(&self->condition_variable);
-        for (size_t i = 0; i < self->n_max_producers; i++)
-        {
-            my_condition_variable_destroy(&self->producer_condition_variables[i]);
-        }
-        break;
-    case MPSC_HANDLE_CREATION_FAILURE_COND_VAR_INIT:
-        if (producer_cond_var_index != -1)
-        {
-            // This means that the main condition variable has been initialized, and must
-            // therefore be destroyed.
-            my_condition_variable_destroy(&self->condition_variable);
-            // NOTE: If `producer_cond_var_index = 0`, then it means that
-            // failure occurred for that condition variable, so we don't
-            // destroy it since it was never created.
-            for (size_t i = 0; i < (size_t)producer_cond_var_index; i++)
-            {
-                my_condition_variable_destroy(&self->producer_condition_variables[i]);
-            }
-        }
-        break;
-    default:
-        break;
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid '%s.stack_size = %zu'; must be 0 or at least %zu\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, field_name, attributes->stack_size, (size_t)PTHREAD_STACK_MIN);
+        abort();
+    }
+    if (
+        attributes->n_cpus > 0 &&
+        attributes->cpus == NULL)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] invalid '%s.cpus = NULL' while 'n_cpus = %zu'\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, field_name, attributes->n_cpus);
+        abort();
     }
-    if (self->producer_condition_variables != NULL)
+#ifdef __linux__
+    for (size_t i = 0; i < attributes->n_cpus; i++)
     {
-        my_free(self->producer_condition_variables);
+        if (
+            attributes->cpus[i] < 0 ||
+            attributes->cpus[i] >= CPU_SETSIZE)
+        {
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] invalid CPU index '%i' in '%s.cpus'\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__, attributes->cpus[i], field_name);
+            abort();
+        }
     }
-    if (self->producer_waiting_ids_queue != NULL)
+#endif
+}
+
+static void my_thread_attributes_init(my_thread_attributes_t *self, const mpsc_thread_attributes_t *attributes)
+{
+    self->stack_size = attributes->stack_size;
+    self->has_affinity = attributes->n_cpus > 0;
+    self->cpus_round_robin = attributes->cpus_round_robin;
+#ifdef __linux__
+    CPU_ZERO(&self->cpus);
+    for (size_t i = 0; i < attributes->n_cpus; i++)
     {
-        my_free(self->producer_waiting_ids_queue);
+        CPU_SET(attributes->cpus[i], &self->cpus);
     }
-    if (self->producers != NULL)
+#endif
+    self->name[0] = '\0';
+    if (attributes->name != NULL)
     {
-        my_free(self->producers);
+        snprintf(self->name, sizeof(self->name), "%s", attributes->name);
     }
-    if (self->producer_thread_ids != NULL)
+    self->sched_priority = 0;
+    self->enabled = (self->stack_size != 0 || self->has_affinity || self->name[0] != '\0');
+}
+
+static bool my_thread_start(my_thread_t *thread, void *(callback)(void *context), void *context, const my_thread_attributes_t *attributes, ssize_t index, bool handle_errors)
+{
+    if (attributes->enabled)
     {
-        my_free(self->producer_thread_ids);
+        // NOTE: Threads from the cache might have been created with a different stack
+        // size, and would keep their affinity and name once parked, so threads with
+        // custom attributes are always created for the occasion.
+        pthread_attr_t thread_attributes;
+        if (pthread_attr_init(&thread_attributes) != 0)
+        {
+            if (handle_errors)
+            {
+                errno = ENOMEM;
+                return false;
+            }
+            fprintf(
+                stderr,
+                "%s:%i %s [Fatal Error] call to pthread_attr_init failed\n",
+                MPSC_SRC_FILE_NAME, __LINE__, __func__);
+            abort();
+        }
+        if (attributes->stack_size != 0)
+        {
+            my_thread_attributes_set_stack_size(&thread_attributes, attributes->stack_size);
+        }
+#ifdef __linux__
+        if (attributes->has_affinity)
+        {
+            cpu_set_t cpus = attributes->cpus;
+            if (
+                attributes->cpus_round_robin &&
+                index >= 0)
+            {
+                size_t n = (size_t)index % (size_t)CPU_COUNT(&attributes->cpus);
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                {
+                    if (CPU_ISSET(cpu, &attributes->cpus) && n-- == 0)
+                    {
+                        CPU_ZERO(&cpus);
+                        CPU_SET(cpu, &cpus);
+                        break;
+                    }
+                }
+            }
+            my_thread_attributes_set_affinity(&thread_attributes, &cpus);
+        }
+#endif
+        if (attributes->sched_priority != 0)
+        {
+            my_thread_attributes_set_fifo_priority(&thread_attributes, attributes->sched_priority);
+        }
+        thread->cached = false;
+        thread->callback = callback;
+        thread->context = context;
+        thread->name[0] = '\0';
+        if (attributes->name[0] != '\0')
+        {
+            // NOTE: The name is truncated rather than the producer's index.
+            char suffix[24] = "";
+            if (index >= 0)
+            {
+                snprintf(suffix, sizeof(suffix), "-%zd", index);
+            }
+            char name[16];
+            size_t max_length = sizeof(name) - 1;
+            size_t suffix_length = strlen(suffix);
+            suffix_length = suffix_length < max_length ? suffix_length : max_length;
+            size_t base_length = strlen(attributes->name);
+            base_length = base_length < max_length - suffix_length ? base_length : max_length - suffix_length;
+            memcpy(name, attributes->name, base_length);
+            memcpy(name + base_length, suffix, suffix_length);
+            name[base_length + suffix_length] = '\0';
+            memcpy(thread->name, name, sizeof(name));
+        }
+        bool ok = my_thread_create_with_attributes(&thread->id, &thread_attributes, my_named_thread_callback, thread, handle_errors);
+        pthread_attr_destroy(&thread_attributes);
+        return ok;
     }
-    if (self->buffer != NULL)
+    my_thread_cache_reap();
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    if (my_thread_cache.max_idle_threads == 0)
     {
-        my_free(self->buffer);
+        my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+        thread->cached = false;
+        return my_thread_create(&thread->id, callback, context, handle_errors);
     }
-    if (self != NULL)
+    thread->cached = true;
+    thread->finished = false;
+    my_cached_thread_t *cached_thread = my_thread_cache.idle_threads;
+    if (cached_thread != NULL)
     {
-        my_free(self);
+        // NOTE: The most recently parked thread is reused first, since it's the
+        // most likely to still have a warm cache.
+        my_thread_cache.idle_threads = cached_thread->next;
+        my_thread_cache.n_idle_threads -= 1;
+        cached_thread->callback = callback;
+        cached_thread->context = context;
+        cached_thread->thread = thread;
+        my_condition_variable_signal(&cached_thread->condition_variable);
+        my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+        return true;
     }
-    errno = custom_errno;
-    return NULL;
-}
-
-static void mpsc_create_params_validate(mpsc_create_params_t *params)
-{
-    if (params->consumer_callback == NULL)
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+    cached_thread = my_malloc(sizeof(my_cached_thread_t), handle_errors);
+    if (cached_thread == NULL)
     {
-        fprintf(
-            stderr,
-            "%s:%i %s [Fatal Error] invalid 'consumer_callback = NULL'\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__);
-        abort();
+        return false;
     }
-    if (
-        params->error_handling_enabled &&
-        params->consumer_error_callback == NULL)
+    if (!my_condition_variable_init(&cached_thread->condition_variable, handle_errors))
     {
-        fprintf(
-            stderr,
-            "%s:%i %s [Fatal Error] invalid 'consumer_error_callback = NULL'; must be present when 'error_handling_enabled = true'\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__);
-        abort();
+        my_free(cached_thread);
+        return false;
     }
-    if (params->n_max_producers == 0)
+    cached_thread->callback = callback;
+    cached_thread->context = context;
+    cached_thread->thread = thread;
+    cached_thread->evicted = false;
+    cached_thread->next = NULL;
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    my_thread_cache.n_threads += 1;
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+    // NOTE: Cached threads are only joined once they exit the cache (see `my_thread_cache_reap`);
+    // `my_thread_wait` waits for the callback to have returned instead.
+    pthread_t id;
+    if (!my_thread_create(&id, my_cached_thread_callback, cached_thread, handle_errors))
     {
-        fprintf(
-            stderr,
-            "%s:%i %s [Fatal Error] invalid 'n_max_producers = 0'; requires at least 1\n",
-            MPSC_SRC_FILE_NAME, __LINE__, __func__);
-        abort();
+        my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+        my_thread_cache.n_threads -= 1;
+        my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+        my_condition_variable_destroy(&cached_thread->condition_variable);
+        my_free(cached_thread);
+        return false;
     }
+    return true;
 }
 
-static void *my_producer_thread_callback(void *context)
+static void *my_named_thread_callback(void *context)
 {
-    mpsc_producer_t *producer = (mpsc_producer_t *)context;
-    (producer->callback)(producer);
-    mpsc_producer_done(producer);
-    return NULL;
+    my_thread_t *thread = (my_thread_t *)context;
+#ifdef __linux__
+    if (thread->name[0] != '\0')
+    {
+        // NOTE: Naming is best effort, so a failure is simply ignored.
+        pthread_setname_np(pthread_self(), thread->name);
+    }
+#endif
+    return (thread->callback)(thread->context);
 }
 
-static void *my_consumer_thread_callback(void *context)
+static void my_thread_wait(my_thread_t *thread)
 {
-    mpsc_t *mpsc = (mpsc_t *)context;
-    pthread_mutex_t *mutex = &mpsc->mutex;
-    pthread_cond_t *condition_variable = &mpsc->condition_variable;
-    mpsc_consumer_callback_t *callback = mpsc->consumer_callback;
-    mpsc_consumer_error_callback_t *error_callback = mpsc->consumer_error_callback;
-    bool error_handling_enabled = mpsc->error_handling_enabled;
-    while (true)
+    if (!thread->cached)
     {
-        my_mutex_set_lock_state(mutex, true);
-        while (
-            !mpsc->pending_message &&
-            !mpsc->closed)
+        my_thread_join(thread->id);
+        return;
+    }
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    while (!thread->finished)
+    {
+        my_condition_variable_wait(&my_thread_cache.finished_condition_variable, &my_thread_cache.mutex);
+    }
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+}
+
+static void *my_cached_thread_callback(void *context)
+{
+    my_cached_thread_t *self = (my_cached_thread_t *)context;
+    my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+    self->id = pthread_self();
+    while (self->callback != NULL)
+    {
+        void *(*callback)(void *context) = self->callback;
+        void *callback_context = self->context;
+        my_mutex_set_lock_state(&my_thread_cache.mutex, false);
+        (callback)(callback_context);
+        my_mutex_set_lock_state(&my_thread_cache.mutex, true);
+        // NOTE: The waiting thread may release the handle as soon as the lock is
+        // released, so it must not be accessed after this.
+        self->thread->finished = true;
+        self->thread = NULL;
+        self->callback = NULL;
+        my_condition_variable_broadcast(&my_thread_cache.finished_condition_variable);
+        if (my_thread_cache.n_idle_threads >= my_thread_cache.max_idle_threads)
         {
-            my_condition_variable_wait(condition_variable, mutex);
+            break;
         }
-        if (
-            mpsc->closed &&
-            !mpsc->pending_message) // NEW: If we have a pending message, we deliver it first
+        self->next = my_thread_cache.idle_threads;
+        my_thread_cache.idle_threads = self;
+        my_thread_cache.n_idle_threads += 1;
+        struct timespec deadline;
+        bool timed = my_thread_cache.idle_timeout_ms > 0;
+        if (timed)
         {
-            my_mutex_set_lock_state(mutex, false);
-            break;
+            my_deadline_from_timeout(&deadline, my_thread_cache.idle_timeout_ms);
         }
-        size_t n = mpsc->n;
-        void *buffer = NULL;
-        if (n > 0)
+        while (
+            self->callback == NULL &&
+            !self->evicted)
         {
-            buffer = my_malloc(mpsc->n, error_handling_enabled);
-            if (buffer == NULL)
+            if (!timed)
             {
-                mpsc->n = 0;
-                mpsc->pending_message = false;
-                my_mutex_set_lock_state(mutex, false);
-                // IMPORTANT: don't hold the lock while calling the callback!
-                (error_callback)(&mpsc->consumer);
-                continue;
+                my_condition_variable_wait(&self->condition_variable, &my_thread_cache.mutex);
+            }
+            else if (!my_condition_variable_timed_wait(&self->condition_variable, &my_thread_cache.mutex, &deadline))
+            {
+                break;
             }
-            memcpy(buffer, mpsc->buffer, n);
         }
-        mpsc->n = 0;
-        mpsc->pending_message = false;
-        if (mpsc->n_producers_waiting > 0 && !mpsc->closed)
+        if (
+            self->callback == NULL &&
+            !self->evicted)
         {
-            size_t id = mpsc->producer_waiting_ids_queue[0];
-            mpsc->next_waiting_producer_id = id;
-            my_condition_variable_signal(&mpsc->producer_condition_variables[id]);
+            // NOTE: Timed out, so we remove ourselves from the idle list.
+            my_cached_thread_t **link = &my_thread_cache.idle_threads;
+            while (*link != self)
+            {
+                link = &(*link)->next;
+            }
+            *link = self->next;
+            my_thread_cache.n_idle_threads -= 1;
         }
-        my_mutex_set_lock_state(mutex, false);
-        // IMPORTANT: don't hold the lock while calling the callback!
-        (callback)(&mpsc->consumer, buffer, n, false);
     }
-    // IMPORTANT: don't hold the lock while calling the callback!
-    (callback)(&mpsc->consumer, NULL, 0, true);
+    // NOTE: The thread is freed by whoever joins it.
+    self->next = my_thread_cache.exited_threads;
+    my_thread_cache.exited_threads = self;
+    my_thread_cache.n_threads -= 1;
+    my_condition_variable_broadcast(&my_thread_cache.finished_condition_variable);
+    my_mutex_set_lock_state(&my_thread_cache.mutex, false);
     return NULL;
 }
 
@@ -638,6 +6341,61 @@ static void my_thread_join(pthread_t id)
     }
 }
 
+static void my_thread_attributes_set_stack_size(pthread_attr_t *attributes, size_t stack_size)
+{
+    int reason_code = pthread_attr_setstacksize(attributes, stack_size);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_attr_setstacksize failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+#ifdef __linux__
+static void my_thread_attributes_set_affinity(pthread_attr_t *attributes, const cpu_set_t *cpus)
+{
+    int reason_code = pthread_attr_setaffinity_np(attributes, sizeof(cpu_set_t), cpus);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_attr_setaffinity_np failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+#endif
+
+static void my_thread_attributes_set_fifo_priority(pthread_attr_t *attributes, int priority)
+{
+    // NOTE: Without `PTHREAD_EXPLICIT_SCHED`, the policy and priority would be
+    // ignored in favor of the creating thread's.
+    struct sched_param sched_param = {.sched_priority = priority};
+    const char *call = "pthread_attr_setinheritsched";
+    int reason_code = pthread_attr_setinheritsched(attributes, PTHREAD_EXPLICIT_SCHED);
+    if (reason_code == 0)
+    {
+        call = "pthread_attr_setschedpolicy";
+        reason_code = pthread_attr_setschedpolicy(attributes, SCHED_FIFO);
+    }
+    if (reason_code == 0)
+    {
+        call = "pthread_attr_setschedparam";
+        reason_code = pthread_attr_setschedparam(attributes, &sched_param);
+    }
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to %s failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, call, reason_code);
+        abort();
+    }
+}
+
 static void my_mutex_set_lock_state(pthread_mutex_t *mutex, bool state)
 {
     if (state)
@@ -679,6 +6437,19 @@ static void my_condition_variable_signal(pthread_cond_t *condition_variable)
     }
 }
 
+static void my_condition_variable_broadcast(pthread_cond_t *condition_variable)
+{
+    int reason_code = pthread_cond_broadcast(condition_variable);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_cond_broadcast failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
 static void my_condition_variable_wait(pthread_cond_t *condition_variable, pthread_mutex_t *mutex)
 {
     int reason_code = pthread_cond_wait(condition_variable, mutex);
@@ -692,9 +6463,91 @@ static void my_condition_variable_wait(pthread_cond_t *condition_variable, pthre
     }
 }
 
+static bool my_condition_variable_timed_wait(pthread_cond_t *condition_variable, pthread_mutex_t *mutex, const struct timespec *deadline)
+{
+    int reason_code = pthread_cond_timedwait(condition_variable, mutex, deadline);
+    if (reason_code == ETIMEDOUT)
+    {
+        return false;
+    }
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_cond_timedwait failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+    return true;
+}
+
+static void my_deadline_from_timeout(struct timespec *deadline, long timeout_ms)
+{
+    // NOTE: `pthread_cond_timedwait` uses `CLOCK_REALTIME` unless the condition
+    // variable was initialized with another clock.
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
 static bool my_mutex_init(pthread_mutex_t *mutex, bool handle_errors)
 {
-    int reason_code = pthread_mutex_init(mutex, NULL);
+    return my_mutex_init_with_attributes(mutex, NULL, handle_errors);
+}
+
+static void my_mutex_attributes_init(pthread_mutexattr_t *attributes)
+{
+    int reason_code = pthread_mutexattr_init(attributes);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_mutexattr_init failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+static void my_mutex_attributes_set_priority_inheritance(pthread_mutexattr_t *attributes)
+{
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+    int reason_code = pthread_mutexattr_setprotocol(attributes, PTHREAD_PRIO_INHERIT);
+#else
+    // NOTE: Unreachable, since real-time mode is rejected on such platforms.
+    (void)attributes;
+    int reason_code = ENOTSUP;
+#endif
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_mutexattr_setprotocol failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+static void my_mutex_attributes_set_process_shared(pthread_mutexattr_t *attributes)
+{
+    int reason_code = pthread_mutexattr_setpshared(attributes, PTHREAD_PROCESS_SHARED);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_mutexattr_setpshared failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+static bool my_mutex_init_with_attributes(pthread_mutex_t *mutex, const pthread_mutexattr_t *attributes, bool handle_errors)
+{
+    int reason_code = pthread_mutex_init(mutex, attributes);
     if (reason_code != 0)
     {
         if (
@@ -728,7 +6581,38 @@ static void my_mutex_destroy(pthread_mutex_t *mutex)
 
 static bool my_condition_variable_init(pthread_cond_t *condition_variable, bool handle_errors)
 {
-    int reason_code = pthread_cond_init(condition_variable, NULL);
+    return my_condition_variable_init_with_attributes(condition_variable, NULL, handle_errors);
+}
+
+static void my_condition_variable_attributes_init(pthread_condattr_t *attributes)
+{
+    int reason_code = pthread_condattr_init(attributes);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_condattr_init failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+static void my_condition_variable_attributes_set_process_shared(pthread_condattr_t *attributes)
+{
+    int reason_code = pthread_condattr_setpshared(attributes, PTHREAD_PROCESS_SHARED);
+    if (reason_code != 0)
+    {
+        fprintf(
+            stderr,
+            "%s:%i %s [Fatal Error] call to pthread_condattr_setpshared failed with code = %i\n",
+            MPSC_SRC_FILE_NAME, __LINE__, __func__, reason_code);
+        abort();
+    }
+}
+
+static bool my_condition_variable_init_with_attributes(pthread_cond_t *condition_variable, const pthread_condattr_t *attributes, bool handle_errors)
+{
+    int reason_code = pthread_cond_init(condition_variable, attributes);
     if (reason_code != 0)
     {
         if (
@@ -762,12 +6646,19 @@ static void my_condition_variable_destroy(pthread_cond_t *condition_variable)
 
 static bool my_thread_create(pthread_t *id, void *(callback)(void *context), void *context, bool handle_errors)
 {
-    int reason_code = pthread_create(id, NULL, callback, context);
+    return my_thread_create_with_attributes(id, NULL, callback, context, handle_errors);
+}
+
+static bool my_thread_create_with_attributes(pthread_t *id, const pthread_attr_t *attributes, void *(callback)(void *context), void *context, bool handle_errors)
+{
+    int reason_code = pthread_create(id, attributes, callback, context);
     if (reason_code != 0)
     {
+        // NOTE: `EPERM` is returned when the caller isn't allowed to use the
+        // requested scheduling policy (see `realtime_enabled`).
         if (
             handle_errors &&
-            reason_code == EAGAIN)
+            (reason_code == EAGAIN || reason_code == EPERM))
         {
             errno = reason_code;
             return false;
@@ -805,3 +6696,198 @@ static void my_free(void *pointer)
 {
     free(pointer);
 }
+
+static void *my_huge_pages_alloc(size_t n, size_t *mapped_size, bool handle_errors)
+{
+    *mapped_size = 0;
+    if (n == 0)
+    {
+        return my_malloc(n, handle_errors);
+    }
+    size_t size = (n + MPSC_HUGE_PAGE_SIZE - 1) / MPSC_HUGE_PAGE_SIZE * MPSC_HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+    // NOTE: Explicit huge pages are only available if the administrator has reserved
+    // some (e.g., through `/proc/sys/vm/nr_hugepages`), in which case they're preferred.
+    void *pointer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (pointer != MAP_FAILED)
+    {
+        *mapped_size = size;
+        return pointer;
+    }
+#endif
+#ifndef MADV_HUGEPAGE
+    // NOTE: Without transparent huge pages (e.g., outside of Linux), aligning the
+    // buffer on a huge page boundary wouldn't change how it's backed.
+    (void)size;
+    return my_malloc(n, handle_errors);
+#else
+    // NOTE: Transparent huge pages can only back huge page aligned ranges, so one extra huge
+    // page is mapped, and the unaligned head and tail are unmapped.
+    char *mapping = mmap(NULL, size + MPSC_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return my_malloc(n, handle_errors);
+    }
+    char *aligned = (char *)(((uintptr_t)mapping + MPSC_HUGE_PAGE_SIZE - 1) / MPSC_HUGE_PAGE_SIZE * MPSC_HUGE_PAGE_SIZE);
+    if (aligned > mapping)
+    {
+        munmap(mapping, (size_t)(aligned - mapping));
+    }
+    size_t tail_size = (size_t)(mapping + size + MPSC_HUGE_PAGE_SIZE - (aligned + size));
+    if (tail_size > 0)
+    {
+        munmap(aligned + size, tail_size);
+    }
+    // NOTE: Best effort; the kernel might not support (or have disabled) transparent huge pages.
+    madvise(aligned, size, MADV_HUGEPAGE);
+    *mapped_size = size;
+    return aligned;
+#endif
+}
+
+static void *my_pages_alloc(size_t n, bool handle_errors)
+{
+    void *pointer = mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pointer != MAP_FAILED)
+    {
+        return pointer;
+    }
+    if (handle_errors)
+    {
+        return NULL;
+    }
+    fprintf(
+        stderr,
+        "%s:%i %s [Fatal Error] call to mmap failed with 'strerror = %s'\n",
+        MPSC_SRC_FILE_NAME, __LINE__, __func__, strerror(errno));
+    abort();
+}
+
+static void my_pages_free(void *pointer, size_t n)
+{
+    if (pointer != NULL)
+    {
+        munmap(pointer, n);
+    }
+}
+
+static void my_huge_pages_free(void *pointer, size_t mapped_size)
+{
+    if (mapped_size == 0)
+    {
+        my_free(pointer);
+        return;
+    }
+    munmap(pointer, mapped_size);
+}
+
+static bool my_read_all(int fd, void *buffer, size_t n)
+{
+    // NOTE: Returns `false` if the end of the file is reached first.
+    size_t offset = 0;
+    while (offset < n)
+    {
+        ssize_t result = read(fd, (char *)buffer + offset, n - offset);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            my_io_failure("read", __LINE__, __func__);
+        }
+        if (result == 0)
+        {
+            return false;
+        }
+        offset += (size_t)result;
+    }
+    return true;
+}
+
+static void my_io_failure(const char *call, int line, const char *function)
+{
+    fprintf(
+        stderr,
+        "%s:%i %s [Fatal Error] call to %s failed with errno = %i\n",
+        MPSC_SRC_FILE_NAME, line, function, call, errno);
+    abort();
+}
+
+static int my_receive_datagrams(int fd, my_datagram_header_t *headers, size_t n)
+{
+    // NOTE: Returns -1 (with `errno` set) only if no datagram could be read.
+#ifdef __linux__
+    return recvmmsg(fd, headers, (unsigned int)n, MSG_DONTWAIT, NULL);
+#else
+    size_t count = 0;
+    while (count < n)
+    {
+        ssize_t result = recvmsg(fd, &headers[count].msg_hdr, MSG_DONTWAIT);
+        if (result < 0)
+        {
+            if (count > 0)
+            {
+                break;
+            }
+            return -1;
+        }
+        headers[count].msg_len = (unsigned int)result;
+        count += 1;
+    }
+    return (int)count;
+#endif
+}
+
+static void my_sleep_until_ns(uint64_t target_ns)
+{
+    // NOTE: `target_ns` is on the same clock as `my_monotonic_ns`. Without `clock_nanosleep`
+    // (e.g., on macOS), the remaining time is slept instead, which can only oversleep.
+#if defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0
+    struct timespec target = {
+        .tv_sec = (time_t)(target_ns / 1000000000u),
+        .tv_nsec = (long)(target_ns % 1000000000u),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL) == EINTR)
+    {
+    }
+#else
+    uint64_t now_ns = my_monotonic_ns();
+    while (now_ns < target_ns)
+    {
+        uint64_t remaining_ns = target_ns - now_ns;
+        struct timespec remaining = {
+            .tv_sec = (time_t)(remaining_ns / 1000000000u),
+            .tv_nsec = (long)(remaining_ns % 1000000000u),
+        };
+        nanosleep(&remaining, NULL);
+        now_ns = my_monotonic_ns();
+    }
+#endif
+}
+
+static int my_fdatasync(int fd)
+{
+    // NOTE: `fdatasync` is optional in POSIX (e.g., macOS doesn't provide it), in which
+    // case `fsync` is used, which also flushes the metadata that isn't needed to read
+    // the file back.
+#if defined(_POSIX_SYNCHRONIZED_IO) && _POSIX_SYNCHRONIZED_IO > 0
+    return fdatasync(fd);
+#else
+    return fsync(fd);
+#endif
+}
+
+static uint64_t my_monotonic_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static void my_counter_add(uint64_t *counter, uint64_t value)
+{
+    // NOTE: Only for counters with a single writer, where a plain load and store (rather
+    // than a locked read-modify-write) is enough, and which are read using relaxed loads.
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}